@@ -7,6 +7,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "api/api_chat_participants.h"
 
+#include "api/api_hash.h"
 #include "apiwrap.h"
 #include "boxes/add_contact_box.h" // ShowAddParticipantsError
 #include "boxes/peers/add_participants_box.h" // ChatInviteForbidden
@@ -38,6 +39,8 @@ constexpr auto kMaxUsersPerInvite = 100;
 // that was added to this chat.
 constexpr auto kForwardMessagesOnAdd = 100;
 
+constexpr auto kMaxCachedSlices = 64;
+
 std::vector<ChatParticipant> ParseList(
 		const ChatParticipants::TLMembers &data,
 		not_null<PeerData*> peer) {
@@ -48,6 +51,22 @@ std::vector<ChatParticipant> ParseList(
 	}) | ranges::to_vector;
 }
 
+[[nodiscard]] uint64 CountSliceHash(
+		const std::vector<ChatParticipant> &list) {
+	return CountHash(ranges::views::all(
+		list
+	) | ranges::views::transform([](const ChatParticipant &p) {
+		return p.userId().bare;
+	}));
+}
+
+ChatParticipants::Parsed ParseAdmins(
+		not_null<ChannelData*> channel,
+		const ChatParticipants::TLMembers &data) {
+	channel->owner().processUsers(data.vusers());
+	return { data.vcount().v, ParseList(data, channel) };
+}
+
 void ApplyMegagroupAdmins(not_null<ChannelData*> channel, Members list) {
 	Expects(channel->isMegagroup());
 
@@ -371,24 +390,28 @@ void ChatParticipants::requestLast(not_null<ChannelData*> channel) {
 		return;
 	}
 
+	const auto filter = MTP_channelParticipantsRecent();
 	const auto offset = 0;
-	const auto participantsHash = uint64(0);
+	const auto limit = channel->session().serverConfig().chatSizeMax;
+	const auto participantsHash = sliceHash(channel, filter, offset, limit);
 	const auto requestId = _api.request(MTPchannels_GetParticipants(
 		channel->inputChannel,
-		MTP_channelParticipantsRecent(),
+		filter,
 		MTP_int(offset),
-		MTP_int(channel->session().serverConfig().chatSizeMax),
+		MTP_int(limit),
 		MTP_long(participantsHash)
 	)).done([=](const MTPchannels_ChannelParticipants &result) {
 		_participantsRequests.remove(channel);
 
-		result.match([&](const MTPDchannels_channelParticipants &data) {
-			const auto &[availableCount, list] = Parse(channel, data);
-			ApplyLastList(channel, availableCount, list);
-		}, [](const MTPDchannels_channelParticipantsNotModified &) {
-			LOG(("API Error: "
-				"channels.channelParticipantsNotModified received!"));
-		});
+		const auto parsed = resolveSlice(
+			channel,
+			filter,
+			offset,
+			limit,
+			result);
+		if (parsed) {
+			ApplyLastList(channel, parsed->availableCount, parsed->list);
+		}
 	}).fail([this, channel] {
 		_participantsRequests.remove(channel);
 	}).send();
@@ -401,23 +424,27 @@ void ChatParticipants::requestBots(not_null<ChannelData*> channel) {
 		return;
 	}
 
+	const auto filter = MTP_channelParticipantsBots();
 	const auto offset = 0;
-	const auto participantsHash = uint64(0);
+	const auto limit = channel->session().serverConfig().chatSizeMax;
+	const auto participantsHash = sliceHash(channel, filter, offset, limit);
 	const auto requestId = _api.request(MTPchannels_GetParticipants(
 		channel->inputChannel,
-		MTP_channelParticipantsBots(),
+		filter,
 		MTP_int(offset),
-		MTP_int(channel->session().serverConfig().chatSizeMax),
+		MTP_int(limit),
 		MTP_long(participantsHash)
 	)).done([=](const MTPchannels_ChannelParticipants &result) {
 		_botsRequests.remove(channel);
-		result.match([&](const MTPDchannels_channelParticipants &data) {
-			const auto &[availableCount, list] = Parse(channel, data);
-			ApplyBotsList(channel, availableCount, list);
-		}, [](const MTPDchannels_channelParticipantsNotModified &) {
-			LOG(("API Error: "
-				"channels.channelParticipantsNotModified received!"));
-		});
+		const auto parsed = resolveSlice(
+			channel,
+			filter,
+			offset,
+			limit,
+			result);
+		if (parsed) {
+			ApplyBotsList(channel, parsed->availableCount, parsed->list);
+		}
 	}).fail([=] {
 		_botsRequests.remove(channel);
 	}).send();
@@ -430,24 +457,29 @@ void ChatParticipants::requestAdmins(not_null<ChannelData*> channel) {
 		return;
 	}
 
+	const auto filter = MTP_channelParticipantsAdmins();
 	const auto offset = 0;
-	const auto participantsHash = uint64(0);
+	const auto limit = channel->session().serverConfig().chatSizeMax;
+	const auto participantsHash = sliceHash(channel, filter, offset, limit);
 	const auto requestId = _api.request(MTPchannels_GetParticipants(
 		channel->inputChannel,
-		MTP_channelParticipantsAdmins(),
+		filter,
 		MTP_int(offset),
-		MTP_int(channel->session().serverConfig().chatSizeMax),
+		MTP_int(limit),
 		MTP_long(participantsHash)
 	)).done([=](const MTPchannels_ChannelParticipants &result) {
 		channel->mgInfo->adminsLoaded = true;
 		_adminsRequests.remove(channel);
-		result.match([&](const MTPDchannels_channelParticipants &data) {
-			channel->owner().processUsers(data.vusers());
-			ApplyMegagroupAdmins(channel, ParseList(data, channel));
-		}, [](const MTPDchannels_channelParticipantsNotModified &) {
-			LOG(("API Error: "
-				"channels.channelParticipantsNotModified received!"));
-		});
+		const auto parsed = resolveSlice(
+			channel,
+			filter,
+			offset,
+			limit,
+			result,
+			ParseAdmins);
+		if (parsed) {
+			ApplyMegagroupAdmins(channel, parsed->list);
+		}
 	}).fail([=] {
 		channel->mgInfo->adminsLoaded = true;
 		_adminsRequests.remove(channel);
@@ -525,6 +557,83 @@ void ChatParticipants::add(
 	}
 }
 
+uint64 ChatParticipants::sliceHash(
+		not_null<ChannelData*> channel,
+		const MTPChannelParticipantsFilter &filter,
+		int offset,
+		int limit) const {
+	const auto i = _slices.find(SliceKey{
+		.channel = channel,
+		.filter = filter.type(),
+		.offset = offset,
+		.limit = limit,
+	});
+	return (i != end(_slices)) ? i->second.hash : uint64(0);
+}
+
+auto ChatParticipants::cachedSlice(
+		not_null<ChannelData*> channel,
+		const MTPChannelParticipantsFilter &filter,
+		int offset,
+		int limit) const
+-> std::optional<Parsed> {
+	const auto i = _slices.find(SliceKey{
+		.channel = channel,
+		.filter = filter.type(),
+		.offset = offset,
+		.limit = limit,
+	});
+	if (i == end(_slices)) {
+		return std::nullopt;
+	}
+	return Parsed{ i->second.availableCount, i->second.list };
+}
+
+auto ChatParticipants::resolveSlice(
+		not_null<ChannelData*> channel,
+		const MTPChannelParticipantsFilter &filter,
+		int offset,
+		int limit,
+		const MTPchannels_ChannelParticipants &result,
+		SliceParser parse)
+-> std::optional<Parsed> {
+	const auto key = SliceKey{
+		.channel = channel,
+		.filter = filter.type(),
+		.offset = offset,
+		.limit = limit,
+	};
+	const auto i = _slices.find(key);
+	return result.match([&](
+			const MTPDchannels_channelParticipants &data)
+	-> std::optional<Parsed> {
+		auto parsed = parse(channel, data);
+		auto slice = Slice{
+			.availableCount = parsed.availableCount,
+			.list = parsed.list,
+			.hash = CountSliceHash(parsed.list),
+		};
+		if (i != end(_slices)) {
+			i->second = std::move(slice);
+		} else {
+			if (_slices.size() >= kMaxCachedSlices) {
+				_slices.clear();
+			}
+			_slices.emplace(key, std::move(slice));
+		}
+		return parsed;
+	}, [&](const MTPDchannels_channelParticipantsNotModified &)
+	-> std::optional<Parsed> {
+		// Users and chats of the slice were processed when it was received.
+		if (i == end(_slices)) {
+			LOG(("API Error: "
+				"channels.channelParticipantsNotModified received!"));
+			return std::nullopt;
+		}
+		return Parsed{ i->second.availableCount, i->second.list };
+	});
+}
+
 ChatParticipants::Parsed ChatParticipants::Parse(
 		not_null<ChannelData*> channel,
 		const TLMembers &data) {
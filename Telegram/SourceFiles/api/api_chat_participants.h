@@ -109,6 +109,31 @@ public:
 		not_null<ChannelData*> channel,
 		Fn<void(const TLMembers&)> callback);
 
+	// Parsed slices requested without a search query are remembered, so
+	// that they can be revalidated by hash instead of being loaded again.
+	// A not modified answer resolves to the remembered participants and
+	// count, without processing the users and chats once again.
+	using SliceParser = Parsed(*)(
+		not_null<ChannelData*> channel,
+		const TLMembers &data);
+	[[nodiscard]] uint64 sliceHash(
+		not_null<ChannelData*> channel,
+		const MTPChannelParticipantsFilter &filter,
+		int offset,
+		int limit) const;
+	[[nodiscard]] std::optional<Parsed> cachedSlice(
+		not_null<ChannelData*> channel,
+		const MTPChannelParticipantsFilter &filter,
+		int offset,
+		int limit) const;
+	[[nodiscard]] std::optional<Parsed> resolveSlice(
+		not_null<ChannelData*> channel,
+		const MTPChannelParticipantsFilter &filter,
+		int offset,
+		int limit,
+		const MTPchannels_ChannelParticipants &result,
+		SliceParser parse = Parse);
+
 	void kick(
 		not_null<ChatData*> chat,
 		not_null<PeerData*> participant);
@@ -121,8 +146,26 @@ public:
 		not_null<PeerData*> participant);
 
 private:
+	struct SliceKey {
+		ChannelData *channel = nullptr;
+		mtpTypeId filter = 0;
+		int offset = 0;
+		int limit = 0;
+
+		friend inline auto operator<=>(
+			const SliceKey&,
+			const SliceKey&) = default;
+	};
+	struct Slice {
+		int availableCount = 0;
+		std::vector<ChatParticipant> list;
+		uint64 hash = 0;
+	};
+
 	MTP::Sender _api;
 
+	base::flat_map<SliceKey, Slice> _slices;
+
 	using PeerRequests = base::flat_map<PeerData*, mtpRequestId>;
 
 	PeerRequests _participantsRequests;
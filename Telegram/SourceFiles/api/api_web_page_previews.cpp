@@ -0,0 +1,147 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "api/api_web_page_previews.h"
+
+#include "apiwrap.h"
+#include "base/unixtime.h"
+#include "data/data_session.h"
+#include "data/data_web_page.h"
+#include "main/main_session.h"
+
+namespace Api {
+namespace {
+
+constexpr auto kCachedLinksLimit = 256;
+constexpr auto kFailedLinkTimeout = 5 * 60 * crl::time(1000);
+constexpr auto kResolvedLinkTimeout = 60 * crl::time(1000);
+
+} // namespace
+
+WebPagePreviews::WebPagePreviews(not_null<ApiWrap*> api)
+: _session(&api->session())
+, _api(&api->instance()) {
+}
+
+std::optional<WebPageData*> WebPagePreviews::lookup(const QString &link) {
+	const auto i = _cache.find(link);
+	if (i == end(_cache)) {
+		return std::nullopt;
+	}
+	const auto now = crl::now();
+	const auto page = i->second.page;
+	if (!page && now - i->second.resolved > kFailedLinkTimeout) {
+		_cache.erase(i);
+		return std::nullopt;
+	}
+	i->second.used = now;
+	return (page && !page->failed) ? page : nullptr;
+}
+
+QString WebPagePreviews::find(not_null<WebPageData*> page) const {
+	for (const auto &[link, entry] : _cache) {
+		if (entry.page == page) {
+			return link;
+		}
+	}
+	return QString();
+}
+
+rpl::producer<QString> WebPagePreviews::resolved() const {
+	return _resolved.events();
+}
+
+bool WebPagePreviews::pending(const QString &link) const {
+	return _requests.contains(link);
+}
+
+bool WebPagePreviews::request(const QString &link, bool force) {
+	if (!force) {
+		const auto i = _cache.find(link);
+		const auto fresh = (i != end(_cache))
+			&& (!i->second.page || !i->second.page->pendingTill)
+			&& (crl::now() - i->second.resolved <= kResolvedLinkTimeout);
+		if (fresh) {
+			crl::on_main(_session, [=] {
+				_resolved.fire_copy(link);
+			});
+			return false;
+		}
+	}
+	auto &pending = _requests[link];
+	++pending.waiters;
+	if (pending.id) {
+		return true;
+	}
+	pending.id = _api.request(
+		MTPmessages_GetWebPagePreview(
+			MTP_flags(0),
+			MTP_string(link),
+			MTPVector<MTPMessageEntity>()
+	)).done([=](const MTPMessageMedia &result) {
+		result.match([&](const MTPDmessageMediaWebPage &data) {
+			const auto page = _session->data().processWebpage(
+				data.vwebpage());
+			if (page->pendingTill > 0
+				&& page->pendingTill < base::unixtime::now()) {
+				page->pendingTill = 0;
+				page->failed = true;
+			}
+			finish(link, page->failed ? nullptr : page.get());
+		}, [&](const auto &d) {
+			finish(link, nullptr);
+		});
+	}).fail([=] {
+		finish(link, nullptr);
+	}).send();
+	return true;
+}
+
+void WebPagePreviews::cancel(const QString &link) {
+	const auto i = _requests.find(link);
+	if (i == end(_requests)) {
+		return;
+	} else if (--i->second.waiters <= 0) {
+		_api.request(i->second.id).cancel();
+		_requests.erase(i);
+	}
+}
+
+void WebPagePreviews::remember(
+		const QString &link,
+		WebPageData *page) {
+	const auto now = crl::now();
+	if (_cache.size() >= kCachedLinksLimit && !_cache.contains(link)) {
+		// Forget the least recently used quarter of the links.
+		auto used = ranges::views::all(
+			_cache
+		) | ranges::views::transform([](const auto &pair) {
+			return pair.second.used;
+		}) | ranges::to_vector;
+		const auto border = begin(used) + (used.size() / 4);
+		ranges::nth_element(used, border);
+		const auto till = *border;
+		auto kept = base::flat_map<QString, Entry>();
+		for (auto &[cached, entry] : _cache) {
+			if (entry.used > till) {
+				kept.emplace(cached, entry);
+			}
+		}
+		_cache = std::move(kept);
+	}
+	_cache[link] = Entry{ .page = page, .used = now, .resolved = now };
+}
+
+void WebPagePreviews::finish(
+		const QString &link,
+		WebPageData *page) {
+	_requests.remove(link);
+	remember(link, page);
+	_resolved.fire_copy(link);
+}
+
+} // namespace Api
@@ -0,0 +1,59 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "mtproto/sender.h"
+
+class ApiWrap;
+
+namespace Main {
+class Session;
+} // namespace Main
+
+namespace Api {
+
+// Resolved links and pending requests of the session, so identical
+// links from different message fields are requested only once.
+class WebPagePreviews final {
+public:
+	explicit WebPagePreviews(not_null<ApiWrap*> api);
+
+	[[nodiscard]] std::optional<WebPageData*> lookup(const QString &link);
+	[[nodiscard]] QString find(not_null<WebPageData*> page) const;
+	[[nodiscard]] rpl::producer<QString> resolved() const;
+	[[nodiscard]] bool pending(const QString &link) const;
+
+	// Each request that returns true adds a waiter for the link and each
+	// cancel removes one. Without force a recently resolved link is
+	// reported from the cache and no waiter is added.
+	[[nodiscard]] bool request(const QString &link, bool force);
+	void cancel(const QString &link);
+
+private:
+	struct Entry {
+		WebPageData *page = nullptr;
+		crl::time used = 0;
+		crl::time resolved = 0;
+	};
+	struct Request {
+		mtpRequestId id = 0;
+		int waiters = 0;
+	};
+
+	void remember(const QString &link, WebPageData *page);
+	void finish(const QString &link, WebPageData *page);
+
+	const not_null<Main::Session*> _session;
+	MTP::Sender _api;
+	base::flat_map<QString, Entry> _cache;
+	base::flat_map<QString, Request> _requests;
+	rpl::event_stream<QString> _resolved;
+
+};
+
+} // namespace Api
@@ -31,6 +31,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "api/api_transcribes.h"
 #include "api/api_premium.h"
 #include "api/api_user_names.h"
+#include "api/api_web_page_previews.h"
 #include "api/api_websites.h"
 #include "data/notify/data_notify_settings.h"
 #include "data/stickers/data_stickers.h"
@@ -182,6 +183,7 @@ ApiWrap::ApiWrap(not_null<Main::Session*> session)
 , _transcribes(std::make_unique<Api::Transcribes>(this))
 , _premium(std::make_unique<Api::Premium>(this))
 , _usernames(std::make_unique<Api::Usernames>(this))
+, _webPagePreviews(std::make_unique<Api::WebPagePreviews>(this))
 , _websites(std::make_unique<Api::Websites>(this)) {
 	crl::on_main(session, [=] {
 		// You can't use _session->lifetime() in the constructor,
@@ -4419,6 +4421,10 @@ Api::Usernames &ApiWrap::usernames() {
 	return *_usernames;
 }
 
+Api::WebPagePreviews &ApiWrap::webPagePreviews() {
+	return *_webPagePreviews;
+}
+
 Api::Websites &ApiWrap::websites() {
 	return *_websites;
 }
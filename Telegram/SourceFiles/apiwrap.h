@@ -80,6 +80,7 @@ class Ringtones;
 class Transcribes;
 class Premium;
 class Usernames;
+class WebPagePreviews;
 class Websites;
 
 namespace details {
@@ -388,6 +389,7 @@ public:
 	[[nodiscard]] Api::Transcribes &transcribes();
 	[[nodiscard]] Api::Premium &premium();
 	[[nodiscard]] Api::Usernames &usernames();
+	[[nodiscard]] Api::WebPagePreviews &webPagePreviews();
 	[[nodiscard]] Api::Websites &websites();
 
 	void updatePrivacyLastSeens();
@@ -702,6 +704,7 @@ private:
 	const std::unique_ptr<Api::Transcribes> _transcribes;
 	const std::unique_ptr<Api::Premium> _premium;
 	const std::unique_ptr<Api::Usernames> _usernames;
+	const std::unique_ptr<Api::WebPagePreviews> _webPagePreviews;
 	const std::unique_ptr<Api::Websites> _websites;
 
 	mtpRequestId _wallPaperRequestId = 0;
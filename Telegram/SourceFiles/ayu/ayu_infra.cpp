@@ -10,6 +10,7 @@
 #include "ayu/ayu_lottie.h"
 #include "ayu/ui/ayu_lottie.h"
 #include "ayu/database/ayu_database.h"
+#include "ayu/database/ayu_database_maintenance.h"
 #include "lang/lang_instance.h"
 #include "ayu/ayu_settings.h"
 
@@ -36,6 +37,7 @@ void initLottie()
 void initDatabase()
 {
 	AyuDatabase::initialize();
+	AyuDatabase::startMaintenance();
 }
 
 void initFonts()
@@ -235,6 +235,21 @@ void AyuGramSettings::set_keepMessagesHistory(bool val)
 	saveMessagesHistory = val;
 }
 
+void AyuGramSettings::set_historyRetentionDays(int val)
+{
+	historyRetentionDays = val;
+}
+
+void AyuGramSettings::set_historyPerDialogLimit(int val)
+{
+	historyPerDialogLimit = val;
+}
+
+void AyuGramSettings::set_databaseSizeLimitMb(int val)
+{
+	databaseSizeLimitMb = val;
+}
+
 void AyuGramSettings::set_disableAds(bool val)
 {
 	disableAds = val;
@@ -51,6 +51,14 @@ public:
 		saveDeletedMessages = true;
 		saveMessagesHistory = true;
 
+		/*
+		 * Zero values mean no limit, otherwise the oldest saved
+		 * messages are removed by the database maintenance
+		 */
+		historyRetentionDays = 0;
+		historyPerDialogLimit = 0;
+		databaseSizeLimitMb = 0;
+
 		// ~ QoL toggles
 		disableAds = true;
 		disableStories = false;
@@ -81,6 +89,12 @@ public:
 		stickerConfirmation = false;
 		gifConfirmation = false;
 		voiceConfirmation = false;
+
+		/*
+		 * Main thread stalls longer than each of those are counted
+		 * by the "stall-watchdog" experimental option
+		 */
+		stallThresholdsMs = {50, 250};
 	}
 
 	bool sendReadMessages;
@@ -94,6 +108,9 @@ public:
 	bool useScheduledMessages;
 	bool saveDeletedMessages;
 	bool saveMessagesHistory;
+	int historyRetentionDays;
+	int historyPerDialogLimit;
+	int databaseSizeLimitMb;
 	bool disableAds;
 	bool disableStories;
 	bool disableNotificationsDelay;
@@ -112,6 +129,7 @@ public:
 	bool stickerConfirmation;
 	bool gifConfirmation;
 	bool voiceConfirmation;
+	std::vector<int> stallThresholdsMs;
 
 public:
 	void set_sendReadMessages(bool val);
@@ -138,6 +156,12 @@ public:
 
 	void set_keepMessagesHistory(bool val);
 
+	void set_historyRetentionDays(int val);
+
+	void set_historyPerDialogLimit(int val);
+
+	void set_databaseSizeLimitMb(int val);
+
 	void set_disableAds(bool val);
 
 	void set_disableStories(bool val);
@@ -188,6 +212,9 @@ NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(
 	useScheduledMessages,
 	saveDeletedMessages,
 	saveMessagesHistory,
+	historyRetentionDays,
+	historyPerDialogLimit,
+	databaseSizeLimitMb,
 	disableAds,
 	disableStories,
 	disableNotificationsDelay,
@@ -205,7 +232,8 @@ NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(
 	hideAllChatsFolder,
 	stickerConfirmation,
 	gifConfirmation,
-	voiceConfirmation
+	voiceConfirmation,
+	stallThresholdsMs
 );
 
 AyuGramSettings &getInstance();
@@ -11,9 +11,65 @@
 
 #include "base/unixtime.h"
 
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+
 using namespace sqlite_orm;
 
-auto storage = make_storage("./tdata/ayudata.db",
+namespace
+{
+
+constexpr auto kBusyTimeout = 1000;
+constexpr auto kAutoVacuumIncremental = 2;
+constexpr auto kRetentionBatch = int64(512);
+constexpr auto kVacuumPagesPerStep = 256;
+
+const auto kRetentionTables = std::array<std::string, 2>{
+	"EditedMessage",
+	"DeletedMessage",
+};
+
+// trigram tokens match any substring of at least that many characters
+constexpr auto kTextIndexMinLength = 3;
+
+// an external content index over the edited text, kept in sync by triggers
+// on any connection, so the retention and maintenance deletes are seen too
+const auto kCreateTextIndex = std::string(
+	"CREATE VIRTUAL TABLE IF NOT EXISTS EditedMessageText USING fts5("
+	"text, content='EditedMessage', tokenize='trigram');"
+	"CREATE TRIGGER IF NOT EXISTS EditedMessageText_ai AFTER INSERT ON EditedMessage BEGIN "
+	"INSERT INTO EditedMessageText(rowid, text) VALUES (new.rowid, new.text); END;"
+	"CREATE TRIGGER IF NOT EXISTS EditedMessageText_ad AFTER DELETE ON EditedMessage BEGIN "
+	"INSERT INTO EditedMessageText(EditedMessageText, rowid, text) "
+	"VALUES ('delete', old.rowid, old.text); END;"
+	"CREATE TRIGGER IF NOT EXISTS EditedMessageText_au AFTER UPDATE ON EditedMessage BEGIN "
+	"INSERT INTO EditedMessageText(EditedMessageText, rowid, text) "
+	"VALUES ('delete', old.rowid, old.text); "
+	"INSERT INTO EditedMessageText(rowid, text) VALUES (new.rowid, new.text); END;");
+
+const auto kRebuildTextIndex = std::string(
+	"INSERT INTO EditedMessageText(EditedMessageText) VALUES ('rebuild')");
+
+}
+
+const std::string databasePath = "./tdata/ayudata.db";
+
+auto storage = make_storage(databasePath,
+							make_index("idx_deleted_message_message",
+									   &DeletedMessage::userId,
+									   &DeletedMessage::dialogId,
+									   &DeletedMessage::messageId),
+							make_index("idx_edited_message_message",
+									   &EditedMessage::userId,
+									   &EditedMessage::dialogId,
+									   &EditedMessage::messageId),
+							make_index("idx_edited_message_date",
+									   &EditedMessage::userId,
+									   &EditedMessage::dialogId,
+									   &EditedMessage::editDate),
 							make_table("DeletedMessage",
 									   make_column("userId", &DeletedMessage::userId),
 									   make_column("dialogId", &DeletedMessage::dialogId),
@@ -93,9 +149,165 @@ auto storage = make_storage("./tdata/ayudata.db",
 							)
 );
 
+// a copy has a connection of its own, it is used for the edit history
+// search on worker threads, one query at a time
+std::optional<decltype(storage)> searchStorage;
+std::mutex searchMutex;
+
+// main thread only, edits wait here while maintenance writes
+std::vector<EditedMessage> pendingEditedMessages;
+bool writesDeferred = false;
+
 namespace AyuDatabase
 {
 
+class RawConnection
+{
+public:
+	RawConnection()
+	{
+		if (sqlite3_open_v2(databasePath.c_str(), &_db, SQLITE_OPEN_READWRITE, nullptr) != SQLITE_OK) {
+			LOG(("Failed to open database for maintenance: %1").arg(sqlite3_errmsg(_db)));
+			sqlite3_close(_db);
+			_db = nullptr;
+		}
+		else {
+			sqlite3_busy_timeout(_db, kBusyTimeout);
+		}
+	}
+
+	~RawConnection()
+	{
+		if (_db) {
+			sqlite3_close(_db);
+		}
+	}
+
+	RawConnection(const RawConnection &) = delete;
+	RawConnection &operator=(const RawConnection &) = delete;
+
+	[[nodiscard]] bool valid() const
+	{
+		return _db != nullptr;
+	}
+
+	// calls back with the first row only, if there is one
+	bool select(const std::string &sql,
+				std::initializer_list<int64> args,
+				Fn<void(sqlite3_stmt *)> row)
+	{
+		return run(sql, nullptr, args, std::move(row), false);
+	}
+
+	// calls back with each row, the text is bound before the numbers
+	bool selectAll(const std::string &sql,
+				   const std::string &text,
+				   std::initializer_list<int64> args,
+				   Fn<void(sqlite3_stmt *)> row)
+	{
+		return run(sql, &text, args, std::move(row), true);
+	}
+
+	std::optional<int64> queryInt(const std::string &sql, std::initializer_list<int64> args = {})
+	{
+		auto result = std::optional<int64>();
+		select(sql, args, [&](sqlite3_stmt *statement)
+		{
+			result = sqlite3_column_int64(statement, 0);
+		});
+		return result;
+	}
+
+	// returns the number of removed rows
+	int64 remove(const std::string &sql, std::initializer_list<int64> args)
+	{
+		return select(sql, args, nullptr) ? sqlite3_changes(_db) : 0;
+	}
+
+	bool execute(const std::string &sql)
+	{
+		char *error = nullptr;
+		if (sqlite3_exec(_db, sql.c_str(), nullptr, nullptr, &error) != SQLITE_OK) {
+			LOG(("Database maintenance error: %1").arg(error));
+			sqlite3_free(error);
+			return false;
+		}
+		return true;
+	}
+
+private:
+	bool run(const std::string &sql,
+			 const std::string *text,
+			 std::initializer_list<int64> args,
+			 Fn<void(sqlite3_stmt *)> row,
+			 bool allRows)
+	{
+		sqlite3_stmt *statement = nullptr;
+		if (sqlite3_prepare_v2(_db, sql.c_str(), -1, &statement, nullptr) != SQLITE_OK) {
+			LOG(("Database maintenance error: %1").arg(sqlite3_errmsg(_db)));
+			return false;
+		}
+		auto index = 0;
+		if (text) {
+			sqlite3_bind_text(statement, ++index, text->c_str(), int(text->size()), SQLITE_TRANSIENT);
+		}
+		for (const auto arg : args) {
+			sqlite3_bind_int64(statement, ++index, arg);
+		}
+		auto code = sqlite3_step(statement);
+		if (code == SQLITE_ROW && row) {
+			row(statement);
+		}
+		while (code == SQLITE_ROW) {
+			code = sqlite3_step(statement);
+			if (code == SQLITE_ROW && allRows && row) {
+				row(statement);
+			}
+		}
+		if (code != SQLITE_DONE) {
+			LOG(("Database maintenance error: %1").arg(sqlite3_errmsg(_db)));
+		}
+		sqlite3_finalize(statement);
+		return (code == SQLITE_DONE);
+	}
+
+	sqlite3 *_db = nullptr;
+};
+
+// set once the text index is created and filled, the text search
+// falls back to LIKE without it (e.g. when FTS5 is not compiled in)
+std::atomic<bool> textIndexReady = false;
+
+bool hasTextIndexTriggers(RawConnection &connection)
+{
+	return connection.queryInt(
+		"SELECT COUNT(*) FROM sqlite_master WHERE type = 'trigger' AND name = 'EditedMessageText_ai'"
+	).value_or(0) > 0;
+}
+
+void setupTextIndex()
+{
+	auto connection = RawConnection();
+	if (!connection.valid()) {
+		return;
+	}
+
+	// a schema sync that recreates the table drops its triggers too,
+	// so the index is filled again whenever they were missing
+	const auto filled = hasTextIndexTriggers(connection);
+	if (!connection.execute("BEGIN")) {
+		return;
+	}
+	if (!connection.execute(kCreateTextIndex)
+		|| (!filled && !connection.execute(kRebuildTextIndex))
+		|| !connection.execute("COMMIT")) {
+		LOG(("Edited messages text index is unavailable, using LIKE search"));
+		connection.execute("ROLLBACK");
+		return;
+	}
+	textIndexReady = true;
+}
+
 void initialize()
 {
 	// move to `tdata` from legacy version
@@ -108,6 +320,20 @@ void initialize()
 		}
 	}
 
+	// each operation opens a connection of its own, so the settings
+	// are applied to every connection right when it is opened
+	storage.on_open = [](sqlite3 *db)
+	{
+		// wait for the maintenance connection instead of failing on a lock
+		sqlite3_busy_timeout(db, kBusyTimeout);
+
+		// applies to new databases only, existing ones switch on compact()
+		sqlite3_exec(db, "PRAGMA auto_vacuum = INCREMENTAL", nullptr, nullptr, nullptr);
+
+		// readers don't wait for the maintenance writes in WAL mode
+		sqlite3_exec(db, "PRAGMA journal_mode = WAL", nullptr, nullptr, nullptr);
+	};
+
 	try {
 		storage.sync_schema();
 	}
@@ -136,35 +362,372 @@ void initialize()
 
 	storage.begin_transaction();
 	storage.commit();
+
+	setupTextIndex();
+
+	searchStorage.emplace(storage);
+}
+
+bool isBusyError(const std::system_error &e)
+{
+	return e.code().category() == get_sqlite_error_category()
+		&& (e.code().value() == SQLITE_BUSY || e.code().value() == SQLITE_LOCKED);
+}
+
+void flushPendingWrites()
+{
+	if (writesDeferred || pendingEditedMessages.empty()) {
+		return;
+	}
+	try {
+		storage.begin_transaction();
+		for (const auto &message : pendingEditedMessages) {
+			storage.insert(message);
+		}
+		storage.commit();
+		pendingEditedMessages.clear();
+	}
+	catch (const std::system_error &e) {
+		LOG(("Failed to save edited messages: %1").arg(e.what()));
+		try {
+			storage.rollback();
+		}
+		catch (...) {
+		}
+		if (!isBusyError(e)) {
+			// retrying won't help, don't keep failing on each edit
+			pendingEditedMessages.clear();
+		}
+	}
+}
+
+bool isRevisionOf(const EditedMessage &message, ID userId, ID dialogId, ID messageId)
+{
+	return message.userId == userId
+		&& message.dialogId == dialogId
+		&& message.messageId == messageId;
+}
+
+void deferWrites(bool deferred)
+{
+	writesDeferred = deferred;
+	flushPendingWrites();
 }
 
 void addEditedMessage(const EditedMessage &message)
 {
-	storage.begin_transaction();
-	storage.insert(message);
-	storage.commit();
+	pendingEditedMessages.push_back(message);
+	flushPendingWrites();
 }
 
 std::vector<EditedMessage> getEditedMessages(ID userId, ID dialogId, ID messageId)
 {
-	return storage.get_all<EditedMessage>(
-		where(
-			c(&EditedMessage::userId) == userId and
-				c(&EditedMessage::dialogId) == dialogId and
-				c(&EditedMessage::messageId) == messageId
-		)
-	);
+	auto result = std::vector<EditedMessage>();
+	try {
+		result = storage.get_all<EditedMessage>(
+			where(
+				c(&EditedMessage::userId) == userId and
+					c(&EditedMessage::dialogId) == dialogId and
+					c(&EditedMessage::messageId) == messageId
+			)
+		);
+	}
+	catch (const std::system_error &e) {
+		LOG(("Failed to read edited messages: %1").arg(e.what()));
+	}
+	for (const auto &message : pendingEditedMessages) {
+		if (isRevisionOf(message, userId, dialogId, messageId)) {
+			result.push_back(message);
+		}
+	}
+	return result;
 }
 
 bool hasRevisions(ID userId, ID dialogId, ID messageId)
 {
-	return storage.count<EditedMessage>(
-		where(
-			c(&EditedMessage::userId) == userId and
-				c(&EditedMessage::dialogId) == dialogId and
-				c(&EditedMessage::messageId) == messageId
-		)
-	) > 0;
+	for (const auto &message : pendingEditedMessages) {
+		if (isRevisionOf(message, userId, dialogId, messageId)) {
+			return true;
+		}
+	}
+	try {
+		return storage.count<EditedMessage>(
+			where(
+				c(&EditedMessage::userId) == userId and
+					c(&EditedMessage::dialogId) == dialogId and
+					c(&EditedMessage::messageId) == messageId
+			)
+		) > 0;
+	}
+	catch (const std::system_error &e) {
+		LOG(("Failed to check edited messages: %1").arg(e.what()));
+		return false;
+	}
+}
+
+std::vector<EditedMessage> findPendingEditedMessages(const EditedMessagesQuery &query)
+{
+	// case insensitive, like the LIKE search of the saved ones
+	const auto text = QString::fromStdString(query.text);
+	const auto matches = [&](const EditedMessage &message)
+	{
+		return message.userId == query.userId
+			&& message.dialogId == query.dialogId
+			&& (!query.messageId || message.messageId == query.messageId)
+			&& message.editDate >= query.minDate
+			&& (!query.maxDate || message.editDate <= query.maxDate)
+			&& (text.isEmpty()
+				|| QString::fromStdString(message.text).contains(text, Qt::CaseInsensitive));
+	};
+
+	auto result = std::vector<EditedMessage>();
+	for (auto i = pendingEditedMessages.rbegin(); i != pendingEditedMessages.rend(); ++i) {
+		if (matches(*i)) {
+			result.push_back(*i);
+		}
+	}
+	return result;
+}
+
+std::string escapeLike(const std::string &text)
+{
+	auto result = std::string();
+	result.reserve(text.size());
+	for (const auto ch : text) {
+		if (ch == '\\' || ch == '%' || ch == '_') {
+			result.push_back('\\');
+		}
+		result.push_back(ch);
+	}
+	return result;
+}
+
+// used with the search storage, under the same mutex
+std::optional<RawConnection> searchConnection;
+
+std::vector<int64> findByTextIndex(RawConnection &connection,
+								   const EditedMessagesQuery &query,
+								   int minMessageId,
+								   int maxMessageId,
+								   int maxDate,
+								   ID offsetId)
+{
+	// a quoted phrase, so the text is matched as is
+	auto phrase = std::string("\"");
+	for (const auto ch : query.text) {
+		if (ch == '"') {
+			phrase.push_back('"');
+		}
+		phrase.push_back(ch);
+	}
+	phrase.push_back('"');
+
+	auto result = std::vector<int64>();
+	const auto ok = connection.valid() && connection.selectAll(
+		"SELECT m.rowid FROM EditedMessageText JOIN EditedMessage m ON m.rowid = EditedMessageText.rowid"
+		" WHERE EditedMessageText MATCH ? AND m.userId = ? AND m.dialogId = ?"
+		" AND m.messageId >= ? AND m.messageId <= ? AND m.editDate >= ? AND m.editDate <= ?"
+		" AND m.rowid < ? ORDER BY m.rowid DESC LIMIT ?",
+		phrase,
+		{query.userId, query.dialogId, minMessageId, maxMessageId, query.minDate, maxDate, offsetId,
+		 query.limit},
+		[&](sqlite3_stmt *statement)
+		{
+			result.push_back(sqlite3_column_int64(statement, 0));
+		});
+	if (!ok) {
+		throw std::runtime_error("text index search failed");
+	}
+	return result;
+}
+
+EditedMessagesSlice findEditedMessages(const EditedMessagesQuery &query)
+{
+	const auto minMessageId = query.messageId
+								  ? query.messageId
+								  : std::numeric_limits<int>::min();
+	const auto maxMessageId = query.messageId
+								  ? query.messageId
+								  : std::numeric_limits<int>::max();
+	const auto maxDate = query.maxDate
+							 ? query.maxDate
+							 : std::numeric_limits<int>::max();
+	const auto offsetId = query.offsetId
+							  ? query.offsetId
+							  : std::numeric_limits<ID>::max();
+	const auto pattern = '%' + escapeLike(query.text) + '%';
+
+	auto lock = std::lock_guard(searchMutex);
+	if (!searchStorage) {
+		return {};
+	}
+	auto &storage = *searchStorage;
+
+	const auto useTextIndex = textIndexReady
+		&& QString::fromStdString(query.text).toUcs4().size() >= kTextIndexMinLength;
+	if (useTextIndex && !searchConnection) {
+		searchConnection.emplace();
+	}
+
+	try {
+		// rowid follows the order in which revisions were saved, so it serves
+		// as a stable cursor, and the dialog indexes cover the rowid lookup.
+		const auto ids = useTextIndex
+			? findByTextIndex(*searchConnection, query, minMessageId, maxMessageId, maxDate, offsetId)
+			: storage.select(
+			rowid<EditedMessage>(),
+			where(
+				c(&EditedMessage::userId) == query.userId and
+					c(&EditedMessage::dialogId) == query.dialogId and
+					c(&EditedMessage::messageId) >= minMessageId and
+					c(&EditedMessage::messageId) <= maxMessageId and
+					c(&EditedMessage::editDate) >= query.minDate and
+					c(&EditedMessage::editDate) <= maxDate and
+					c(rowid<EditedMessage>()) < offsetId and
+					like(&EditedMessage::text, pattern, "\\")
+			),
+			order_by(rowid<EditedMessage>()).desc(),
+			limit(query.limit)
+		);
+		if (ids.empty()) {
+			return {};
+		}
+
+		auto result = EditedMessagesSlice();
+		result.list = storage.get_all<EditedMessage>(
+			where(in(rowid<EditedMessage>(), ids)),
+			order_by(rowid<EditedMessage>()).desc()
+		);
+		if (int(ids.size()) == query.limit) {
+			result.nextOffsetId = ids.back();
+		}
+		return result;
+	}
+	catch (const std::exception &e) {
+		LOG(("Failed to search edited messages: %1").arg(e.what()));
+		return {};
+	}
+}
+
+DatabaseStats readStats(RawConnection &connection)
+{
+	const auto pages = connection.queryInt("PRAGMA page_count").value_or(0);
+	const auto free = connection.queryInt("PRAGMA freelist_count").value_or(0);
+	const auto pageSize = connection.queryInt("PRAGMA page_size").value_or(0);
+	return {
+		.size = pages * pageSize,
+		.reclaimable = free * pageSize,
+	};
+}
+
+int64 removeOldest(RawConnection &connection,
+				   const std::string &table,
+				   const std::string &condition,
+				   std::initializer_list<int64> args)
+{
+	// rowid grows with the time a message was saved,
+	// so the oldest messages are always removed first
+	return connection.remove(
+		"DELETE FROM " + table + " WHERE rowid IN (SELECT rowid FROM " + table
+			+ (condition.empty() ? "" : " WHERE " + condition)
+			+ " ORDER BY rowid LIMIT ?)",
+		args);
+}
+
+bool applyRetentionStep(const RetentionPolicy &policy)
+{
+	auto connection = RawConnection();
+	if (!connection.valid()) {
+		return false;
+	}
+
+	if (policy.maxAgeDays > 0) {
+		const auto before = int64(base::unixtime::now()) - int64(policy.maxAgeDays) * 86400;
+		for (const auto &table : kRetentionTables) {
+			if (removeOldest(connection, table, "entityCreateDate < ?", {before, kRetentionBatch}) > 0) {
+				return true;
+			}
+		}
+	}
+
+	if (policy.maxPerDialog > 0) {
+		for (const auto &table : kRetentionTables) {
+			auto userId = ID();
+			auto dialogId = ID();
+			auto excess = int64();
+
+			// an index scan over (userId, dialogId, messageId)
+			connection.select(
+				"SELECT userId, dialogId, COUNT(*) FROM " + table
+					+ " GROUP BY userId, dialogId HAVING COUNT(*) > ? LIMIT 1",
+				{policy.maxPerDialog},
+				[&](sqlite3_stmt *statement)
+				{
+					userId = sqlite3_column_int64(statement, 0);
+					dialogId = sqlite3_column_int64(statement, 1);
+					excess = sqlite3_column_int64(statement, 2) - policy.maxPerDialog;
+				});
+			if (excess > 0) {
+				removeOldest(connection,
+							 table,
+							 "userId = ? AND dialogId = ?",
+							 {userId, dialogId, std::min(excess, kRetentionBatch)});
+				return true;
+			}
+		}
+	}
+
+	if (policy.maxSizeBytes > 0) {
+		const auto stats = readStats(connection);
+		if (stats.size - stats.reclaimable > policy.maxSizeBytes) {
+			// trim the table that holds the oldest saved message
+			const std::string *oldest = nullptr;
+			auto oldestDate = std::numeric_limits<int64>::max();
+			for (const auto &table : kRetentionTables) {
+				const auto date = connection.queryInt(
+					"SELECT entityCreateDate FROM " + table + " ORDER BY rowid LIMIT 1");
+				if (date && *date < oldestDate) {
+					oldest = &table;
+					oldestDate = *date;
+				}
+			}
+			if (oldest && removeOldest(connection, *oldest, std::string(), {kRetentionBatch}) > 0) {
+				return true;
+			}
+		}
+	}
+
+	const auto mode = connection.queryInt("PRAGMA auto_vacuum").value_or(0);
+	if (mode == kAutoVacuumIncremental && readStats(connection).reclaimable > 0) {
+		connection.execute("PRAGMA incremental_vacuum(" + std::to_string(kVacuumPagesPerStep) + ")");
+		return readStats(connection).reclaimable > 0;
+	}
+	return false;
+}
+
+DatabaseStats collectStats()
+{
+	auto connection = RawConnection();
+	return connection.valid() ? readStats(connection) : DatabaseStats();
+}
+
+bool compact()
+{
+	auto connection = RawConnection();
+	if (!connection.valid()) {
+		return false;
+	}
+
+	// switching an existing database to incremental mode needs a full vacuum
+	if (!connection.execute("PRAGMA auto_vacuum = INCREMENTAL")
+		|| !connection.execute("VACUUM")) {
+		return false;
+	}
+
+	// the messages have no INTEGER PRIMARY KEY, so vacuum may renumber
+	// their rowids, and the text index refers to them by rowid
+	return !hasTextIndexTriggers(connection)
+		|| connection.execute(kRebuildTextIndex);
 }
 
 }
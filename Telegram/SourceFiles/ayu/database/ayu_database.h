@@ -13,10 +13,59 @@
 namespace AyuDatabase
 {
 
+struct EditedMessagesQuery
+{
+	ID userId = 0;
+	ID dialogId = 0;
+	int messageId = 0; // zero for all messages of the dialog
+	int minDate = 0;
+	int maxDate = 0; // zero for no upper bound
+	std::string text; // substring to look for, empty for any text
+	int limit = 100;
+	ID offsetId = 0; // continue with revisions saved before this one
+};
+
+struct EditedMessagesSlice
+{
+	std::vector<EditedMessage> list; // newest first
+	ID nextOffsetId = 0; // zero if there are no more revisions
+};
+
+struct RetentionPolicy
+{
+	int maxAgeDays = 0; // zero to keep messages forever
+	int maxPerDialog = 0; // zero for no per dialog limit
+	int64 maxSizeBytes = 0; // zero for no total size limit
+};
+
+struct DatabaseStats
+{
+	int64 size = 0;
+	int64 reclaimable = 0;
+};
+
 void initialize();
 
+// These are called from the main thread only.
+// While writes are deferred, new edits are kept in memory and saved once
+// writes are resumed, so the main thread never waits for maintenance.
+void deferWrites(bool deferred);
 void addEditedMessage(const EditedMessage &message);
 std::vector<EditedMessage> getEditedMessages(ID userId, ID dialogId, ID messageId);
 bool hasRevisions(ID userId, ID dialogId, ID messageId);
 
+// Edits kept in memory that match the query, newest first.
+std::vector<EditedMessage> findPendingEditedMessages(const EditedMessagesQuery &query);
+
+// Uses a connection of its own and may be called from any thread.
+// Sees saved edits only, the ones kept in memory are found separately.
+EditedMessagesSlice findEditedMessages(const EditedMessagesQuery &query);
+
+// These use a connection of their own and may be called from any thread.
+// A retention step removes a small batch of the oldest messages over the
+// policy limits or frees some unused pages, returns true if more is left.
+bool applyRetentionStep(const RetentionPolicy &policy);
+DatabaseStats collectStats();
+bool compact();
+
 }
@@ -0,0 +1,130 @@
+// This is the source code of AyuGram for Desktop.
+//
+// We do not and cannot prevent the use of our code,
+// but be respectful and credit the original author.
+//
+// Copyright @Radolyn, 2023
+#include "ayu_database_maintenance.h"
+
+#include "ayu/ayu_settings.h"
+
+#include "base/timer.h"
+#include "core/application.h"
+
+namespace AyuDatabase
+{
+
+namespace
+{
+
+constexpr auto kFirstCheckDelay = 60 * crl::time(1000);
+constexpr auto kCheckInterval = 30 * 60 * crl::time(1000);
+constexpr auto kIdleTimeout = 30 * crl::time(1000);
+constexpr auto kStepDelay = crl::time(200);
+
+class Maintenance final
+{
+public:
+	Maintenance()
+		: _timer([=]
+				 { step(); })
+	{
+		_timer.callOnce(kFirstCheckDelay);
+	}
+
+	void compact(Fn<void(bool success)> done)
+	{
+		// never run a vacuum while a retention step holds the database
+		_compacting.push_back(std::move(done));
+		if (_compacting.size() == 1 && !_running) {
+			startCompact();
+		}
+	}
+
+private:
+	void step()
+	{
+		if (_running || !_compacting.empty()) {
+			return;
+		}
+		const auto idle = crl::now() - Core::App().lastNonIdleTime();
+		if (idle < kIdleTimeout) {
+			_timer.callOnce(kIdleTimeout - idle);
+			return;
+		}
+		_running = true;
+		deferWrites(true);
+		crl::async([=, policy = currentRetentionPolicy()]
+				   {
+					   const auto more = applyRetentionStep(policy);
+					   crl::on_main([=]
+									{
+										stepDone(more);
+									});
+				   });
+	}
+
+	void stepDone(bool more)
+	{
+		_running = false;
+		deferWrites(false);
+		if (!_compacting.empty()) {
+			startCompact();
+		}
+		else {
+			_timer.callOnce(more ? kStepDelay : kCheckInterval);
+		}
+	}
+
+	void startCompact()
+	{
+		_running = true;
+		deferWrites(true);
+		crl::async([=]
+				   {
+					   const auto success = AyuDatabase::compact();
+					   crl::on_main([=]
+									{
+										_running = false;
+										deferWrites(false);
+										for (const auto &callback : base::take(_compacting)) {
+											callback(success);
+										}
+										_timer.callOnce(kCheckInterval);
+									});
+				   });
+	}
+
+	base::Timer _timer;
+	std::vector<Fn<void(bool success)>> _compacting;
+	bool _running = false;
+};
+
+std::optional<Maintenance> maintenance = std::nullopt;
+
+}
+
+void startMaintenance()
+{
+	if (!maintenance.has_value()) {
+		maintenance.emplace();
+	}
+}
+
+void compactAsync(Fn<void(bool success)> done)
+{
+	startMaintenance();
+	maintenance->compact(std::move(done));
+}
+
+RetentionPolicy currentRetentionPolicy()
+{
+	const auto settings = &AyuSettings::getInstance();
+	return {
+		.maxAgeDays = settings->historyRetentionDays,
+		.maxPerDialog = settings->historyPerDialogLimit,
+		.maxSizeBytes = int64(settings->databaseSizeLimitMb) * 1024 * 1024,
+	};
+}
+
+}
@@ -0,0 +1,23 @@
+// This is the source code of AyuGram for Desktop.
+//
+// We do not and cannot prevent the use of our code,
+// but be respectful and credit the original author.
+//
+// Copyright @Radolyn, 2023
+#pragma once
+
+#include "ayu_database.h"
+
+namespace AyuDatabase
+{
+
+// Applies the retention settings in small steps on a background thread,
+// only while the app is idle, so the database never grows unbounded.
+void startMaintenance();
+
+// Runs a full vacuum on a background thread, calls back on the main one.
+void compactAsync(Fn<void(bool success)> done);
+
+RetentionPolicy currentRetentionPolicy();
+
+}
@@ -22,6 +22,8 @@
 
 #include "main/main_session.h"
 
+#include <QtCore/QPointer>
+
 namespace AyuMessages
 {
 
@@ -80,6 +82,29 @@ void map(HistoryMessageEdition &edition, not_null<HistoryItem *> item, EditedMes
 	// message.mimeType;
 }
 
+void streamEditedMessages(not_null<QObject *> guard,
+						  AyuDatabase::EditedMessagesQuery query,
+						  Fn<void(std::vector<EditedMessage> &&list, bool last)> callback)
+{
+	// pages are read on a worker thread one by one, so a text search
+	// through a large history doesn't block the UI
+	crl::async([=]() mutable
+	{
+		auto slice = AyuDatabase::findEditedMessages(query);
+		crl::on_main(guard, [=, slice = std::move(slice)]() mutable
+		{
+			const auto last = !slice.nextOffsetId;
+			const auto weak = QPointer<QObject>(guard.get());
+
+			callback(std::move(slice.list), last);
+			if (!last && weak) {
+				query.offsetId = slice.nextOffsetId;
+				streamEditedMessages(guard, std::move(query), std::move(callback));
+			}
+		});
+	});
+}
+
 void ayu_messages_controller::addEditedMessage(HistoryMessageEdition &edition, not_null<HistoryItem *> item)
 {
 	EditedMessage message;
@@ -106,4 +131,42 @@ bool ayu_messages_controller::hasRevisions(not_null<HistoryItem *> item)
 	return AyuDatabase::hasRevisions(userId, dialogId, msgId);
 }
 
+void ayu_messages_controller::searchEditedMessages(not_null<QObject *> guard,
+												   not_null<PeerData *> peer,
+												   AyuDatabase::EditedMessagesQuery query,
+												   Fn<void(std::vector<EditedMessage> &&list, bool last)> callback)
+{
+	query.userId = peer->session().userId().bare;
+	query.dialogId = getDialogIdFromPeer(peer);
+
+	auto pending = AyuDatabase::findPendingEditedMessages(query);
+	if (query.offsetId || pending.empty()) {
+		streamEditedMessages(guard, std::move(query), std::move(callback));
+		return;
+	}
+
+	// edits that are not saved yet are newer than the saved ones, so they
+	// go on top of the first page, without the ones saved in the meantime
+	const auto kept = std::make_shared<std::vector<EditedMessage>>(std::move(pending));
+	const auto isKept = [=](const EditedMessage &message)
+	{
+		return std::any_of(kept->begin(), kept->end(), [&](const EditedMessage &other)
+		{
+			return other.dialogId == message.dialogId
+				&& other.messageId == message.messageId
+				&& other.editDate == message.editDate
+				&& other.text == message.text;
+		});
+	};
+	streamEditedMessages(guard, std::move(query), [=](std::vector<EditedMessage> &&list, bool last)
+	{
+		if (!kept->empty()) {
+			list.erase(std::remove_if(list.begin(), list.end(), isKept), list.end());
+			list.insert(list.begin(), kept->begin(), kept->end());
+			kept->clear();
+		}
+		callback(std::move(list), last);
+	});
+}
+
 }
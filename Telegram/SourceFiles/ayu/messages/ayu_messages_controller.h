@@ -6,6 +6,7 @@
 // Copyright @Radolyn, 2023
 #pragma once
 
+#include "ayu/database/ayu_database.h"
 #include "ayu/database/entities.h"
 
 #include "history/history_item_edition.h"
@@ -19,6 +20,14 @@ public:
 	void addEditedMessage(HistoryMessageEdition &edition, not_null<HistoryItem *> item);
 	std::vector<EditedMessage> getEditedMessages(HistoryItem *item);
 	bool hasRevisions(not_null<HistoryItem *> item);
+
+	// Pages through the edit history of the peer on a worker thread,
+	// calling back on the main thread with each page until the last one
+	// (or the guard dies).
+	void searchEditedMessages(not_null<QObject *> guard,
+							  not_null<PeerData *> peer,
+							  AyuDatabase::EditedMessagesQuery query,
+							  Fn<void(std::vector<EditedMessage> &&list, bool last)> callback);
 };
 
 ayu_messages_controller &getInstance();
@@ -254,11 +254,13 @@ InnerWidget::InnerWidget(
 	QWidget *parent,
 	not_null<Window::SessionController *> controller,
 	not_null<PeerData *> peer,
-	not_null<HistoryItem *> item)
+	HistoryItem *item,
+	TimeId maxDate)
 	: RpWidget(parent),
 	  _controller(controller),
 	  _peer(peer),
 	  _item(item),
+	  _maxDate(maxDate),
 	  _history(peer->owner().history(peer)),
 	  _api(&_peer->session().mtp()),
 	  _pathGradient(
@@ -682,13 +684,41 @@ void InnerWidget::restoreState(not_null<SectionMemento *> memento)
 
 void InnerWidget::addEvents(Direction direction)
 {
-	auto messages = AyuMessages::getInstance().getEditedMessages(_item);
+	if (_eventsRequested) {
+		return;
+	}
+	_eventsRequested = true;
+
+	auto query = AyuDatabase::EditedMessagesQuery();
+	query.messageId = _item ? int(_item->id.bare) : 0;
+	query.maxDate = _maxDate;
+
+	// pages come newest first and each one is shown as soon as it is read,
+	// older revisions go below the ones already shown
+	AyuMessages::getInstance().searchEditedMessages(
+		this,
+		_history->peer,
+		std::move(query),
+		[=](std::vector<EditedMessage> &&list, bool)
+		{
+			ranges::reverse(list);
+			eventsLoaded(Direction::Down, std::move(list));
+		});
+}
+
+void InnerWidget::eventsLoaded(
+	Direction direction,
+	std::vector<EditedMessage> &&messages)
+{
 	if (messages.empty()) {
 		return;
 	}
 
 	const auto size = messages.size();
-	auto &container = _items;
+	auto newItemsForDownDirection = std::vector<OwnedItem>();
+	auto &container = (direction == Direction::Up)
+						  ? _items
+						  : newItemsForDownDirection;
 
 	for (const auto &message : messages) {
 		const auto addOne = [&](
@@ -708,6 +738,13 @@ void InnerWidget::addEvents(Direction direction)
 			message,
 			addOne);
 	}
+	if (direction == Direction::Down) {
+		newItemsForDownDirection.insert(
+			newItemsForDownDirection.end(),
+			std::make_move_iterator(_items.begin()),
+			std::make_move_iterator(_items.end()));
+		_items = std::move(newItemsForDownDirection);
+	}
 
 	itemsAdded(direction, size);
 	update();
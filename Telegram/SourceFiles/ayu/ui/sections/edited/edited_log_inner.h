@@ -57,7 +57,8 @@ public:
 		QWidget *parent,
 		not_null<Window::SessionController *> controller,
 		not_null<PeerData *> peer,
-		not_null<HistoryItem *> item);
+		HistoryItem *item,
+		TimeId maxDate);
 
 	[[nodiscard]] Main::Session &session() const;
 	[[nodiscard]] not_null<Ui::ChatTheme *> theme() const
@@ -212,6 +213,9 @@ private:
 	void updateEmptyText();
 	void paintEmpty(Painter &p, not_null<const Ui::ChatStyle *> st);
 	void addEvents(Direction direction);
+	void eventsLoaded(
+		Direction direction,
+		std::vector<EditedMessage> &&messages);
 	Element *viewForItem(const HistoryItem *item);
 
 	void toggleScrollDateShown();
@@ -247,7 +251,8 @@ private:
 
 	const not_null<Window::SessionController *> _controller;
 	const not_null<PeerData *> _peer;
-	const not_null<HistoryItem *> _item;
+	HistoryItem *const _item; // nullptr for the whole dialog
+	const TimeId _maxDate = 0; // zero for no upper bound
 	const not_null<History *> _history;
 	MTP::Sender _api;
 
@@ -283,6 +288,7 @@ private:
 	bool _upLoaded = true;
 	bool _downLoaded = true;
 	bool _filterChanged = false;
+	bool _eventsRequested = false;
 	Ui::Text::String _emptyText;
 
 	MouseAction _mouseAction = MouseAction::None;
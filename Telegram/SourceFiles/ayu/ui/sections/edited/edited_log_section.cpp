@@ -9,6 +9,7 @@
 #include "ayu/ui/sections/edited/edited_log_inner.h"
 #include "profile/profile_back_button.h"
 #include "core/shortcuts.h"
+#include "ui/boxes/calendar_box.h"
 #include "ui/effects/animations.h"
 #include "ui/widgets/scroll_area.h"
 #include "ui/widgets/shadow.h"
@@ -22,6 +23,7 @@
 #include "window/window_session_controller.h"
 #include "ui/boxes/confirm_box.h"
 #include "base/timer.h"
+#include "base/unixtime.h"
 #include "data/data_channel.h"
 #include "data/data_session.h"
 #include "lang/lang_keys.h"
@@ -29,6 +31,7 @@
 #include "styles/style_chat_helpers.h"
 #include "styles/style_window.h"
 #include "styles/style_info.h"
+#include "styles/style_ayu_styles.h"
 
 namespace EditedLog
 {
@@ -39,7 +42,8 @@ public:
 	FixedBar(
 		QWidget *parent,
 		not_null<Window::SessionController *> controller,
-		not_null<PeerData *> peer);
+		not_null<PeerData *> peer,
+		Fn<void()> showCalendar);
 
 	// When animating mode is enabled the content is hidden and the
 	// whole fixed bar acts like a back button.
@@ -56,6 +60,7 @@ private:
 	not_null<Window::SessionController *> _controller;
 	not_null<PeerData *> _peer;
 	object_ptr<Profile::BackButton> _backButton;
+	object_ptr<Ui::IconButton> _calendar = { nullptr };
 	object_ptr<Ui::CrossButton> _cancel;
 
 	bool _animatingMode = false;
@@ -70,7 +75,7 @@ object_ptr<Window::SectionWidget> SectionMemento::createWidget(
 	if (column == Window::Column::Third) {
 		return nullptr;
 	}
-	auto result = object_ptr<Widget>(parent, controller, _peer, _item);
+	auto result = object_ptr<Widget>(parent, controller, _peer, _item, _maxDate);
 	result->setInternalState(geometry, this);
 	return result;
 }
@@ -78,7 +83,8 @@ object_ptr<Window::SectionWidget> SectionMemento::createWidget(
 FixedBar::FixedBar(
 	QWidget *parent,
 	not_null<Window::SessionController *> controller,
-	not_null<PeerData *> peer)
+	not_null<PeerData *> peer,
+	Fn<void()> showCalendar)
 	: TWidget(parent), _controller(controller), _peer(peer), _backButton(
 	this,
 	&controller->session(),
@@ -89,6 +95,11 @@ FixedBar::FixedBar(
 	_backButton->setClickedCallback([=]
 									{ goBack(); });
 
+	if (showCalendar) {
+		_calendar.create(this, st::editedLogCalendar);
+		_calendar->setClickedCallback(std::move(showCalendar));
+	}
+
 	_cancel->hide(anim::type::instant);
 }
 
@@ -100,6 +111,10 @@ void FixedBar::goBack()
 int FixedBar::resizeGetHeight(int newWidth)
 {
 	auto filterLeft = newWidth;
+	if (_calendar) {
+		filterLeft -= _calendar->width();
+		_calendar->moveToLeft(filterLeft, 0);
+	}
 
 	auto cancelLeft = filterLeft - _cancel->width();
 	_cancel->moveToLeft(cancelLeft, 0);
@@ -155,12 +170,15 @@ Widget::Widget(
 	QWidget *parent,
 	not_null<Window::SessionController *> controller,
 	not_null<PeerData *> peer,
-	not_null<HistoryItem *> item)
+	HistoryItem *item,
+	TimeId maxDate)
 	: Window::SectionWidget(parent, controller, rpl::single<PeerData *>(peer)),
 	  _scroll(this, st::historyScroll, false),
-	  _fixedBar(this, controller, peer),
+	  _fixedBar(this, controller, peer, item ? Fn<void()>() : [=]
+	  { showCalendar(); }),
 	  _fixedBarShadow(this),
-	  _item(item)
+	  _item(item),
+	  _maxDate(maxDate)
 {
 	_fixedBar->move(0, 0);
 	_fixedBar->resizeToWidth(width());
@@ -174,7 +192,7 @@ Widget::Widget(
 								 updateAdaptiveLayout();
 							 }, lifetime());
 
-	_inner = _scroll->setOwnedWidget(object_ptr<InnerWidget>(this, controller, peer, item));
+	_inner = _scroll->setOwnedWidget(object_ptr<InnerWidget>(this, controller, peer, item, maxDate));
 	_inner->scrollToSignal(
 	) | rpl::start_with_next([=](int top)
 							 {
@@ -232,7 +250,9 @@ bool Widget::showInternal(
 	const Window::SectionShow &params)
 {
 	if (auto logMemento = dynamic_cast<SectionMemento *>(memento.get())) {
-		if (logMemento->getPeer() == channel()) {
+		if (logMemento->getPeer() == channel()
+			&& logMemento->getItem() == _item
+			&& logMemento->getMaxDate() == _maxDate) {
 			restoreState(logMemento);
 			return true;
 		}
@@ -252,9 +272,31 @@ void Widget::setupShortcuts()
 	// todo: smth
 }
 
+void Widget::showCalendar()
+{
+	const auto today = QDate::currentDate();
+	const auto highlighted = _maxDate
+								 ? base::unixtime::parse(_maxDate).date()
+								 : today;
+	const auto peer = channel();
+	const auto navigation = controller();
+	controller()->show(Box<Ui::CalendarBox>(Ui::CalendarBoxArgs{
+		.month = highlighted,
+		.highlighted = highlighted,
+		.callback = [=](const QDate &date)
+		{
+			// the edits made till the end of the chosen day
+			const auto maxDate = base::unixtime::serialize(date.addDays(1).startOfDay()) - 1;
+			navigation->hideLayer();
+			navigation->showSection(std::make_shared<SectionMemento>(peer, nullptr, maxDate));
+		},
+		.maxDate = today,
+	}));
+}
+
 std::shared_ptr<Window::SectionMemento> Widget::createMemento()
 {
-	auto result = std::make_shared<SectionMemento>(channel(), _item);
+	auto result = std::make_shared<SectionMemento>(channel(), _item, _maxDate);
 	saveState(result.get());
 	return result;
 }
@@ -37,7 +37,8 @@ public:
 		QWidget *parent,
 		not_null<Window::SessionController *> controller,
 		not_null<PeerData *> peer,
-		not_null<HistoryItem *> item);
+		HistoryItem *item,
+		TimeId maxDate);
 
 	not_null<PeerData *> channel() const;
 	Dialogs::RowDescriptor activeChat() const override;
@@ -75,12 +76,14 @@ private:
 	void saveState(not_null<SectionMemento *> memento);
 	void restoreState(not_null<SectionMemento *> memento);
 	void setupShortcuts();
+	void showCalendar();
 
 	object_ptr<Ui::ScrollArea> _scroll;
 	QPointer<InnerWidget> _inner;
 	object_ptr<FixedBar> _fixedBar;
 	object_ptr<Ui::PlainShadow> _fixedBarShadow;
-	not_null<HistoryItem *> _item;
+	HistoryItem *_item = nullptr;
+	TimeId _maxDate = 0;
 
 };
 
@@ -89,9 +92,12 @@ class SectionMemento : public Window::SectionMemento
 public:
 	using Element = HistoryView::Element;
 
-	SectionMemento(not_null<PeerData *> peer, not_null<HistoryItem *> item)
+	// Without an item shows the edits of the whole dialog, made before
+	// the maxDate if it is set.
+	SectionMemento(not_null<PeerData *> peer, HistoryItem *item, TimeId maxDate = 0)
 		: _peer(peer),
-		  _item(item)
+		  _item(item),
+		  _maxDate(maxDate)
 	{
 	}
 
@@ -105,6 +111,14 @@ public:
 	{
 		return _peer;
 	}
+	HistoryItem *getItem() const
+	{
+		return _item;
+	}
+	TimeId getMaxDate() const
+	{
+		return _maxDate;
+	}
 	void setScrollTop(int scrollTop)
 	{
 		_scrollTop = scrollTop;
@@ -144,7 +158,8 @@ public:
 
 private:
 	not_null<PeerData *> _peer;
-	not_null<HistoryItem *> _item;
+	HistoryItem *_item = nullptr;
+	TimeId _maxDate = 0;
 	int _scrollTop = 0;
 	std::vector<not_null<UserData *>> _admins;
 	std::vector<not_null<UserData *>> _adminsCanEdit;
@@ -6,6 +6,7 @@
 // Copyright @Radolyn, 2023
 #include "settings_ayu.h"
 #include "ayu/ayu_settings.h"
+#include "ayu/database/ayu_database_maintenance.h"
 #include "ayu/sync/ayu_sync_controller.h"
 #include "ayu/ui/boxes/edit_deleted_mark.h"
 #include "ayu/ui/boxes/edit_edited_mark.h"
@@ -38,6 +39,7 @@
 #include "ui/painter.h"
 #include "ui/boxes/confirm_box.h"
 #include "ui/boxes/single_choice_box.h"
+#include "ui/text/format_values.h"
 #include "ui/text/text_utilities.h"
 #include "ui/toast/toast.h"
 #include "ui/widgets/buttons.h"
@@ -278,6 +280,51 @@ not_null<Ui::RpWidget *> AddInnerToggle(
 namespace Settings
 {
 
+void AddLimitButton(
+	not_null<Ui::VerticalLayout *> container,
+	not_null<Window::SessionController *> controller,
+	tr::phrase<> title,
+	std::vector<int> values,
+	Fn<QString(int)> format,
+	int current,
+	Fn<void(int)> save)
+{
+	if (!ranges::contains(values, current)) {
+		values.push_back(current);
+	}
+	const auto options = ranges::views::all(
+		values
+	) | ranges::views::transform(format) | ranges::to_vector;
+	const auto selected = container->lifetime().make_state<rpl::variable<int>>(
+		int(ranges::find(values, current) - begin(values)));
+
+	const auto button = AddButtonWithLabel(
+		container,
+		title(),
+		selected->value() | rpl::map([=](int index)
+									 {
+										 return options[index];
+									 }),
+		st::settingsButtonNoIcon);
+	button->addClickHandler([=]
+							{
+								controller->show(Box([=](not_null<Ui::GenericBox *> box)
+													 {
+														 SingleChoiceBox(box, {
+															 .title = title(),
+															 .options = options,
+															 .initialSelection = selected->current(),
+															 .callback = [=](int index)
+															 {
+																 *selected = index;
+																 save(values[index]);
+																 AyuSettings::save();
+															 },
+														 });
+													 }));
+							});
+}
+
 rpl::producer<QString> Ayu::title()
 {
 	return tr::ayu_AyuPreferences();
@@ -674,6 +721,119 @@ void Ayu::SetupSpyEssentials(not_null<Ui::VerticalLayout *> container)
 										 }, container->lifetime());
 }
 
+void Ayu::SetupDatabase(not_null<Ui::VerticalLayout *> container,
+						not_null<Window::SessionController *> controller)
+{
+	auto settings = &AyuSettings::getInstance();
+
+	AddLimitButton(
+		container,
+		controller,
+		tr::ayu_DatabaseKeepFor,
+		{0, 7, 30, 90, 180, 365},
+		[](int days)
+		{
+			if (!days) {
+				return tr::ayu_DatabaseForever(tr::now);
+			}
+			else if (!(days % 365)) {
+				return tr::lng_years(tr::now, lt_count, days / 365);
+			}
+			else if (!(days % 30)) {
+				return tr::lng_months(tr::now, lt_count, days / 30);
+			}
+			else if (!(days % 7)) {
+				return tr::lng_weeks(tr::now, lt_count, days / 7);
+			}
+			return tr::lng_days(tr::now, lt_count, days);
+		},
+		settings->historyRetentionDays,
+		[=](int days)
+		{
+			settings->set_historyRetentionDays(days);
+		});
+
+	AddLimitButton(
+		container,
+		controller,
+		tr::ayu_DatabaseDialogLimit,
+		{0, 10, 50, 100, 500, 1000},
+		[](int count)
+		{
+			return count ? QString::number(count) : tr::ayu_DatabaseUnlimited(tr::now);
+		},
+		settings->historyPerDialogLimit,
+		[=](int count)
+		{
+			settings->set_historyPerDialogLimit(count);
+		});
+
+	AddLimitButton(
+		container,
+		controller,
+		tr::ayu_DatabaseSizeLimit,
+		{0, 100, 250, 500, 1024, 5120},
+		[](int megabytes)
+		{
+			return megabytes
+					   ? Ui::FormatSizeText(int64(megabytes) * 1024 * 1024)
+					   : tr::ayu_DatabaseUnlimited(tr::now);
+		},
+		settings->databaseSizeLimitMb,
+		[=](int megabytes)
+		{
+			settings->set_databaseSizeLimitMb(megabytes);
+		});
+
+	const auto size = container->lifetime().make_state<rpl::variable<QString>>();
+	const auto reclaimable = container->lifetime().make_state<rpl::variable<QString>>();
+	const auto refresh = [=]
+	{
+		crl::async([=]
+				   {
+					   const auto stats = AyuDatabase::collectStats();
+					   crl::on_main(container.get(), [=]
+					   {
+						   *size = Ui::FormatSizeText(stats.size);
+						   *reclaimable = Ui::FormatSizeText(stats.reclaimable);
+					   });
+				   });
+	};
+	refresh();
+
+	AddButtonWithLabel(
+		container,
+		tr::ayu_DatabaseSize(),
+		size->value(),
+		st::settingsButtonNoIcon);
+	AddButtonWithLabel(
+		container,
+		tr::ayu_DatabaseReclaimable(),
+		reclaimable->value(),
+		st::settingsButtonNoIcon);
+
+	const auto compacting = container->lifetime().make_state<bool>(false);
+	AddButton(
+		container,
+		tr::ayu_DatabaseCompact(),
+		st::settingsButtonNoIcon
+	)->addClickHandler([=]
+					   {
+						   if (*compacting) {
+							   return;
+						   }
+						   *compacting = true;
+						   AyuDatabase::compactAsync(crl::guard(container.get(), [=](bool success)
+						   {
+							   *compacting = false;
+							   if (success) {
+								   controller->showToast(tr::ayu_DatabaseCompacted(tr::now));
+							   }
+							   refresh();
+						   }));
+					   });
+}
+
 void Ayu::SetupQoLToggles(not_null<Ui::VerticalLayout *> container)
 {
 	auto settings = &AyuSettings::getInstance();
@@ -1084,6 +1244,11 @@ void Ayu::SetupAyuGramSettings(not_null<Ui::VerticalLayout *> container,
 
 	AddDivider(container);
 
+	AddSkip(container);
+	SetupDatabase(container, controller);
+	AddSkip(container);
+	AddDividerText(container, tr::ayu_DatabaseRetentionHint());
+
 	AddSkip(container);
 	SetupQoLToggles(container);
 	AddSkip(container);
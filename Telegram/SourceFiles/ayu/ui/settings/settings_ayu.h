@@ -46,6 +46,8 @@ private:
 
 	void SetupSpyEssentials(not_null<Ui::VerticalLayout *> container);
 
+	void SetupDatabase(not_null<Ui::VerticalLayout *> container, not_null<Window::SessionController *> controller);
+
 	void SetupQoLToggles(not_null<Ui::VerticalLayout *> container);
 
 	void SetupAppIcon(not_null<Ui::VerticalLayout *> container);
@@ -134,7 +134,7 @@ void ChooseReplacement(
 		};
 
 		const auto checkResult = [=](const Ui::PreparedList &list) {
-			if (list.files.size() != 1) {
+			if (list.files.size() != 1 || !list.filesToProcess.empty()) {
 				return false;
 			}
 			const auto &file = list.files.front();
@@ -307,7 +307,7 @@ void EditCaptionBox::StartMediaReplace(
 		controller->showToast(t(tr::now));
 	};
 	const auto checkResult = [=](const Ui::PreparedList &list) {
-		if (list.files.size() != 1) {
+		if (list.files.size() != 1 || !list.filesToProcess.empty()) {
 			return false;
 		}
 		const auto &file = list.files.front();
@@ -322,6 +322,10 @@ void EditCaptionBox::StartMediaReplace(
 		}
 		return true;
 	};
+	// Lists for SendFilesBox come with all files still unprepared.
+	if (list.filesToProcess.size() == 1) {
+		Storage::PrepareFirstFile(list, st::sendMediaPreviewSize);
+	}
 	if (list.error != Ui::PreparedList::Error::None) {
 		showError(tr::lng_send_media_invalid_files);
 	} else if (checkResult(list)) {
@@ -18,6 +18,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/emoji_config.h"
 #include "storage/storage_account.h"
 #include "storage/cache/storage_cache_database.h"
+#include "storage/storage_cache_lookups.h"
+#include "storage/storage_cache_quotas.h"
 #include "data/data_session.h"
 #include "lang/lang_keys.h"
 #include "mainwindow.h"
@@ -34,6 +36,8 @@ constexpr auto kMinimalSizeLimit = 100 * kMegabyte;
 constexpr auto kTimeLimitsCount = 16;
 constexpr auto kMaxTimeLimitValue = std::numeric_limits<size_type>::max();
 constexpr auto kFakeMediaCacheTag = uint16(0xFFFF);
+constexpr auto kMinLookupsForHitRate = 10;
+constexpr auto kTagQuotasCount = 9;
 
 int64 TotalSizeLimitInMB(int index) {
 	if (index < 8) {
@@ -65,6 +69,19 @@ QString SizeLimitText(int64 limit) {
 		: (QString::number(mb) + " MB");
 }
 
+int64 TagQuota(int index) {
+	constexpr auto kQuotasInMB = std::array<int64, kTagQuotasCount>{
+		0, 50, 100, 200, 300, 500, 1024, 2048, 4096,
+	};
+	return kQuotasInMB[index] * kMegabyte;
+}
+
+QString TagQuotaText(int64 quota) {
+	return quota
+		? SizeLimitText(quota)
+		: tr::lng_local_storage_limit_none(tr::now);
+}
+
 size_type TimeLimitInDays(int index) {
 	if (index < 3) {
 		const auto weeks = (index + 1);
@@ -129,6 +146,7 @@ public:
 		const Database::TaggedSummary &data);
 
 	void update(const Database::TaggedSummary &data);
+	void updateHitRate(std::optional<int> percent);
 	void toggleProgress(bool shown);
 
 	rpl::producer<> clearRequests() const;
@@ -143,6 +161,8 @@ private:
 	void radialAnimationCallback();
 
 	Fn<QString(size_type)> _titleFactory;
+	Database::TaggedSummary _data;
+	std::optional<int> _hitRate;
 	object_ptr<Ui::FlatLabel> _title;
 	object_ptr<Ui::FlatLabel> _description;
 	object_ptr<Ui::FlatLabel> _clearing = { nullptr };
@@ -158,6 +178,7 @@ LocalStorageBox::Row::Row(
 	const Database::TaggedSummary &data)
 : RpWidget(parent)
 , _titleFactory(std::move(title))
+, _data(data)
 , _title(
 	this,
 	titleText(data),
@@ -172,6 +193,7 @@ LocalStorageBox::Row::Row(
 }
 
 void LocalStorageBox::Row::update(const Database::TaggedSummary &data) {
+	_data = data;
 	if (data.count != 0) {
 		_title->setText(titleText(data));
 	}
@@ -179,6 +201,13 @@ void LocalStorageBox::Row::update(const Database::TaggedSummary &data) {
 	_clear->setVisible(data.count != 0);
 }
 
+void LocalStorageBox::Row::updateHitRate(std::optional<int> percent) {
+	if (_hitRate != percent) {
+		_hitRate = percent;
+		_description->setText(sizeText(_data));
+	}
+}
+
 void LocalStorageBox::Row::toggleProgress(bool shown) {
 	if (!shown) {
 		_progress = nullptr;
@@ -260,9 +289,17 @@ QString LocalStorageBox::Row::titleText(const Database::TaggedSummary &data) con
 }
 
 QString LocalStorageBox::Row::sizeText(const Database::TaggedSummary &data) const {
-	return data.totalSize
-		? Ui::FormatSizeText(data.totalSize)
-		: tr::lng_local_storage_empty(tr::now);
+	if (!data.totalSize) {
+		return tr::lng_local_storage_empty(tr::now);
+	} else if (!_hitRate) {
+		return Ui::FormatSizeText(data.totalSize);
+	}
+	return tr::lng_local_storage_hit_rate(
+		tr::now,
+		lt_size,
+		Ui::FormatSizeText(data.totalSize),
+		lt_percent,
+		QString::number(*_hitRate) + '%');
 }
 
 LocalStorageBox::LocalStorageBox(
@@ -277,6 +314,7 @@ LocalStorageBox::LocalStorageBox(
 	_totalSizeLimit = settings.totalSizeLimit + settingsBig.totalSizeLimit;
 	_mediaSizeLimit = settingsBig.totalSizeLimit;
 	_timeLimit = settings.totalTimeLimit;
+	_tagQuotas = session->local().cacheTagQuotas();
 }
 
 void LocalStorageBox::Show(not_null<::Main::Session*> session) {
@@ -326,9 +364,11 @@ void LocalStorageBox::update(
 	}
 	for (const auto &entry : _rows) {
 		if (entry.first == kFakeMediaCacheTag) {
+			entry.second->entity()->updateHitRate(hitRate(entry.first));
 			updateRow(entry.second, &_statsBig.full);
 		} else if (entry.first) {
 			const auto i = _stats.tagged.find(entry.first);
+			entry.second->entity()->updateHitRate(hitRate(entry.first));
 			updateRow(
 				entry.second,
 				(i != end(_stats.tagged)) ? &i->second : nullptr);
@@ -346,6 +386,18 @@ auto LocalStorageBox::summary() const -> Database::TaggedSummary {
 	return result;
 }
 
+std::optional<int> LocalStorageBox::hitRate(uint16 tag) const {
+	const auto lookups = _session->data().cacheLookups();
+	const auto stats = (tag == kFakeMediaCacheTag)
+		? lookups->bigFileCounts()
+		: lookups->counts(uint8(tag));
+	const auto total = stats.hits + stats.misses;
+	if (total < kMinLookupsForHitRate) {
+		return std::nullopt;
+	}
+	return int(base::SafeRound(stats.hits * 100. / total));
+}
+
 void LocalStorageBox::clearByTag(uint16 tag) {
 	if (tag == kFakeMediaCacheTag) {
 		_dbBig->clear();
@@ -419,6 +471,9 @@ void LocalStorageBox::setupControls() {
 	createTagRow(Data::kVoiceMessageCacheTag, tr::lng_local_storage_voice);
 	createTagRow(Data::kVideoMessageCacheTag, tr::lng_local_storage_round);
 	createTagRow(Data::kAnimationCacheTag, tr::lng_local_storage_animation);
+	createTagRow(
+		Data::kTranslationCacheTag,
+		tr::lng_local_storage_translation);
 	tracker.track(createRow(
 		kFakeMediaCacheTag,
 		std::move(mediaCacheTitle),
@@ -558,6 +613,46 @@ void LocalStorageBox::setupLimits(not_null<Ui::VerticalLayout*> container) {
 			label->setText(tr::lng_local_storage_time_limit(tr::now, lt_limit, text));
 			limitsChanged();
 		});
+
+	container->add(
+		object_ptr<Ui::PlainShadow>(container),
+		st::localStorageRowPadding);
+
+	const auto createQuotaSlider = [&](uint8 tag, auto &&phrase) {
+		const auto i = _tagQuotas.find(tag);
+		createLimitsSlider(
+			container,
+			kTagQuotasCount,
+			TagQuota,
+			(i != end(_tagQuotas)) ? i->second : int64(),
+			[=](not_null<Ui::LabelSimple*> label, int64 quota) {
+				if (quota) {
+					_tagQuotas[tag] = quota;
+				} else {
+					_tagQuotas.remove(tag);
+				}
+				label->setText(phrase(
+					tr::now,
+					lt_size,
+					TagQuotaText(quota)));
+				limitsChanged();
+			});
+	};
+	createQuotaSlider(
+		Data::kImageCacheTag,
+		tr::lng_local_storage_image_limit);
+	createQuotaSlider(
+		Data::kStickerCacheTag,
+		tr::lng_local_storage_sticker_limit);
+	createQuotaSlider(
+		Data::kVoiceMessageCacheTag,
+		tr::lng_local_storage_voice_limit);
+	createQuotaSlider(
+		Data::kVideoMessageCacheTag,
+		tr::lng_local_storage_round_limit);
+	createQuotaSlider(
+		Data::kAnimationCacheTag,
+		tr::lng_local_storage_animation_limit);
 }
 
 void LocalStorageBox::limitsChanged() {
@@ -567,7 +662,8 @@ void LocalStorageBox::limitsChanged() {
 	const auto changed = (settings.totalSizeLimit != sizeLimit)
 		|| (settingsBig.totalSizeLimit != _mediaSizeLimit)
 		|| (settings.totalTimeLimit != _timeLimit)
-		|| (settingsBig.totalTimeLimit != _timeLimit);
+		|| (settingsBig.totalTimeLimit != _timeLimit)
+		|| (_session->local().cacheTagQuotas() != _tagQuotas);
 	if (_limitsChanged != changed) {
 		_limitsChanged = changed;
 		clearButtons();
@@ -593,5 +689,7 @@ void LocalStorageBox::save() {
 	updateBig.totalTimeLimit = _timeLimit;
 	_session->local().updateCacheSettings(update, updateBig);
 	_session->data().cache().updateSettings(update);
+	_session->local().updateCacheTagQuotas(_tagQuotas);
+	_session->data().cacheQuotas().setQuotas(_tagQuotas);
 	closeBox();
 }
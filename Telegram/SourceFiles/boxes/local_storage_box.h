@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "boxes/abstract_box.h"
 #include "storage/cache/storage_cache_database.h"
+#include "storage/storage_cache_quotas.h"
 
 namespace Main {
 class Session;
@@ -63,6 +64,7 @@ private:
 	void save();
 
 	Database::TaggedSummary summary() const;
+	std::optional<int> hitRate(uint16 tag) const;
 
 	template <
 		typename Value,
@@ -97,6 +99,7 @@ private:
 	int64 _totalSizeLimit = 0;
 	int64 _mediaSizeLimit = 0;
 	size_type _timeLimit = 0;
+	Storage::CacheTagQuotas _tagQuotas;
 	bool _limitsChanged = false;
 
 };
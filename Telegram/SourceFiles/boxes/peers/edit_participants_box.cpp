@@ -1265,6 +1265,9 @@ void ParticipantsBoxController::unload() {
 	if (const auto requestId = base::take(_loadRequestId)) {
 		_api.request(requestId).cancel();
 	}
+	for (const auto requestId : base::take(_revalidateRequests)) {
+		_api.request(requestId).cancel();
+	}
 	_allLoaded = false;
 	_offset = 0;
 }
@@ -1466,64 +1469,139 @@ void ParticipantsBoxController::loadMoreRows() {
 	const auto perPage = (_offset > 0)
 		? kParticipantsPerPage
 		: kParticipantsFirstPageCount;
-	const auto participantsHash = uint64(0);
+	const auto offset = _offset;
+	const auto participants = &channel->session().api().chatParticipants();
+	const auto participantsHash = participants->sliceHash(
+		channel,
+		filter,
+		offset,
+		perPage);
+	const auto firstLoad = !offset;
+	const auto wasRecentRequest = firstLoad
+		&& (_role == Role::Members || _role == Role::Profile)
+		&& channel->canViewMembers();
+
+	// A remembered slice is shown right away and the request only
+	// revalidates it by hash, so the next page can be loaded meanwhile.
+	const auto cached = participants->cachedSlice(
+		channel,
+		filter,
+		offset,
+		perPage);
+	if (cached) {
+		applySlice(cached->list, firstLoad);
+	}
 
-	_loadRequestId = _api.request(MTPchannels_GetParticipants(
+	const auto requestId = _api.request(MTPchannels_GetParticipants(
 		channel->inputChannel,
 		filter,
-		MTP_int(_offset),
+		MTP_int(offset),
 		MTP_int(perPage),
 		MTP_long(participantsHash)
-	)).done([=](const MTPchannels_ChannelParticipants &result) {
-		auto added = false;
-		const auto firstLoad = !_offset;
-		_loadRequestId = 0;
-
-		auto wasRecentRequest = firstLoad
-			&& (_role == Role::Members || _role == Role::Profile)
-			&& channel->canViewMembers();
-
-		result.match([&](const MTPDchannels_channelParticipants &data) {
-			const auto &[availableCount, list] = wasRecentRequest
-				? Api::ChatParticipants::ParseRecent(channel, data)
-				: Api::ChatParticipants::Parse(channel, data);
-			for (const auto &data : list) {
-				if (const auto participant = _additional.applyParticipant(
-						data)) {
-					if (appendRow(participant)) {
-						added = true;
-					}
-				}
-			}
-			if (const auto size = list.size()) {
-				_offset += size;
-			} else {
-				// To be sure - wait for a whole empty result list.
-				_allLoaded = true;
+	)).done([=](
+			const MTPchannels_ChannelParticipants &result,
+			mtpRequestId requestId) {
+		if (cached) {
+			_revalidateRequests.remove(requestId);
+		} else {
+			_loadRequestId = 0;
+		}
+		const auto parsed = participants->resolveSlice(
+			channel,
+			filter,
+			offset,
+			perPage,
+			result,
+			(wasRecentRequest
+				? Api::ChatParticipants::ParseRecent
+				: Api::ChatParticipants::Parse));
+		if (cached) {
+			if (parsed) {
+				revalidateSlice(cached->list, parsed->list);
 			}
-		}, [](const MTPDchannels_channelParticipantsNotModified &) {
-			LOG(("API Error: "
-				"channels.channelParticipantsNotModified received!"));
-		});
-		if (_offset > 0 && _role == Role::Admins && channel->isMegagroup()) {
-			if (channel->mgInfo->admins.empty() && channel->mgInfo->adminsLoaded) {
-				channel->mgInfo->adminsLoaded = false;
+		} else {
+			applySlice(
+				parsed ? parsed->list : std::vector<Api::ChatParticipant>(),
+				firstLoad);
+		}
+	}).fail([=](const MTP::Error &error, mtpRequestId requestId) {
+		if (cached) {
+			_revalidateRequests.remove(requestId);
+		} else {
+			_loadRequestId = 0;
+		}
+	}).send();
+	if (cached) {
+		_revalidateRequests.emplace(requestId);
+	} else {
+		_loadRequestId = requestId;
+	}
+}
+
+void ParticipantsBoxController::applySlice(
+		const std::vector<Api::ChatParticipant> &list,
+		bool firstLoad) {
+	auto added = false;
+	for (const auto &data : list) {
+		if (const auto participant = _additional.applyParticipant(data)) {
+			if (appendRow(participant)) {
+				added = true;
 			}
 		}
-		if (!firstLoad && !added) {
-			_allLoaded = true;
+	}
+	if (const auto size = list.size()) {
+		_offset += size;
+	} else {
+		// To be sure - wait for a whole empty result list.
+		_allLoaded = true;
+	}
+	const auto channel = _peer->asChannel();
+	if (_offset > 0 && _role == Role::Admins && channel->isMegagroup()) {
+		if (channel->mgInfo->admins.empty() && channel->mgInfo->adminsLoaded) {
+			channel->mgInfo->adminsLoaded = false;
 		}
-		if (_allLoaded
-			|| (firstLoad && delegate()->peerListFullRowsCount() > 0)) {
-			refreshDescription();
+	}
+	if (!firstLoad && !added) {
+		_allLoaded = true;
+	}
+	if (_allLoaded
+		|| (firstLoad && delegate()->peerListFullRowsCount() > 0)) {
+		refreshDescription();
+	}
+	if (_onlineSorter) {
+		_onlineSorter->sort();
+	}
+	refreshRows();
+}
+
+void ParticipantsBoxController::revalidateSlice(
+		const std::vector<Api::ChatParticipant> &was,
+		const std::vector<Api::ChatParticipant> &now) {
+	auto fresh = base::flat_set<PeerId>();
+	fresh.reserve(now.size());
+	for (const auto &data : now) {
+		fresh.emplace(data.id());
+		if (const auto participant = _additional.applyParticipant(data)) {
+			appendRow(participant);
 		}
-		if (_onlineSorter) {
-			_onlineSorter->sort();
+	}
+	for (const auto &data : was) {
+		if (fresh.contains(data.id())) {
+			continue;
+		} else if (const auto peer = _peer->owner().peerLoaded(data.id())) {
+			removeRow(peer);
 		}
-		refreshRows();
-	}).fail([this] {
-		_loadRequestId = 0;
-	}).send();
+	}
+	// Pages after this one were requested from the remembered size.
+	_offset += int(now.size()) - int(was.size());
+	if (now.empty()) {
+		_allLoaded = true;
+	}
+	refreshDescription();
+	if (_onlineSorter) {
+		_onlineSorter->sort();
+	}
+	refreshRows();
 }
 
 void ParticipantsBoxController::refreshDescription() {
@@ -242,6 +242,12 @@ private:
 	void addNewItem();
 	void addNewParticipants();
 
+	void applySlice(
+		const std::vector<Api::ChatParticipant> &list,
+		bool firstLoad);
+	void revalidateSlice(
+		const std::vector<Api::ChatParticipant> &was,
+		const std::vector<Api::ChatParticipant> &now);
 	void refreshDescription();
 	void setupListChangeViewers();
 	void showAdmin(not_null<UserData*> user);
@@ -285,6 +291,7 @@ private:
 	Role _role = Role::Admins;
 	int _offset = 0;
 	mtpRequestId _loadRequestId = 0;
+	base::flat_set<mtpRequestId> _revalidateRequests;
 	bool _allLoaded = false;
 	ParticipantsAdditionalData _additional;
 	std::unique_ptr<ParticipantsOnlineSorter> _onlineSorter;
@@ -69,6 +69,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace {
 
 constexpr auto kMaxMessageLength = 4096;
+constexpr auto kMaxPreparingFiles = 4;
 
 using Ui::SendFilesWay;
 
@@ -398,31 +399,35 @@ void SendFilesBox::initPreview() {
 }
 
 void SendFilesBox::enqueueNextPrepare() {
-	if (_preparing) {
-		return;
-	}
-	while (!_list.filesToProcess.empty()
-		&& _list.filesToProcess.front().information) {
+	const auto sideLimit = PhotoSideLimit(); // Get on main thread.
+	while (true) {
+		while (!_preparing.empty() && _preparing.front()) {
+			addFile(std::move(*_preparing.front()));
+			_preparing.pop_front();
+			++_preparingFirstId;
+		}
+		if (_list.filesToProcess.empty()
+			|| _preparing.size() >= kMaxPreparingFiles) {
+			return;
+		}
 		auto file = std::move(_list.filesToProcess.front());
 		_list.filesToProcess.pop_front();
-		addFile(std::move(file));
-	}
-	if (_list.filesToProcess.empty()) {
-		return;
-	}
-	auto file = std::move(_list.filesToProcess.front());
-	_list.filesToProcess.pop_front();
-	const auto weak = Ui::MakeWeak(this);
-	_preparing = true;
-	const auto sideLimit = PhotoSideLimit(); // Get on main thread.
-	crl::async([weak, sideLimit, file = std::move(file)]() mutable {
-		Storage::PrepareDetails(file, st::sendMediaPreviewSize, sideLimit);
-		crl::on_main([weak, file = std::move(file)]() mutable {
-			if (weak) {
-				weak->addPreparedAsyncFile(std::move(file));
-			}
+		if (file.information) {
+			_preparing.push_back(std::move(file));
+			continue;
+		}
+		const auto id = _preparingFirstId + _preparing.size();
+		const auto weak = Ui::MakeWeak(this);
+		_preparing.push_back(std::nullopt);
+		crl::async([=, file = std::move(file)]() mutable {
+			Storage::PrepareDetails(file, st::sendMediaPreviewSize, sideLimit);
+			crl::on_main([=, file = std::move(file)]() mutable {
+				if (weak) {
+					weak->addPreparedAsyncFile(id, std::move(file));
+				}
+			});
 		});
-	});
+	}
 }
 
 void SendFilesBox::prepare() {
@@ -710,6 +715,7 @@ void SendFilesBox::generatePreviewFrom(int fromBlock) {
 	using Type = Ui::PreparedFile::Type;
 
 	_blocks.erase(_blocks.begin() + fromBlock, _blocks.end());
+	refreshPreparingPlaceholder();
 
 	const auto fromItem = _blocks.empty() ? 0 : _blocks.back().tillIndex();
 	Assert(fromItem <= _list.files.size());
@@ -743,6 +749,22 @@ void SendFilesBox::generatePreviewFrom(int fromBlock) {
 	}
 }
 
+void SendFilesBox::refreshPreparingPlaceholder() {
+	if (!_list.files.empty() || _preparing.empty()) {
+		_preparingPlaceholder = nullptr;
+		return;
+	} else if (_preparingPlaceholder) {
+		return;
+	}
+	_preparingPlaceholder.reset(Ui::CreateChild<Ui::FlatLabel>(
+		_inner.data(),
+		tr::lng_contacts_loading(tr::now),
+		st::editMediaHintLabel));
+	_inner->add(
+		object_ptr<Ui::RpWidget>::fromRaw(_preparingPlaceholder.get()),
+		st::boxRowPadding);
+}
+
 void SendFilesBox::pushBlock(int from, int till) {
 	const auto gifPaused = [show = _show] {
 		return show->paused(Window::GifPauseReason::Layer);
@@ -1155,10 +1177,7 @@ bool SendFilesBox::addFiles(not_null<const QMimeData*> data) {
 	auto list = [&] {
 		const auto urls = Core::ReadMimeUrls(data);
 		auto result = CanAddUrls(urls)
-			? Storage::PrepareMediaList(
-				urls,
-				st::sendMediaPreviewSize,
-				premium)
+			? Storage::CollectMediaList(urls, premium)
 			: Ui::PreparedList(
 				Ui::PreparedList::Error::EmptyFile,
 				QString());
@@ -1179,6 +1198,7 @@ bool SendFilesBox::addFiles(Ui::PreparedList list) {
 	if (list.error != Ui::PreparedList::Error::None) {
 		return false;
 	}
+	_slowmodeToastShown = false;
 	const auto count = int(_list.files.size());
 	_list.filesToProcess.insert(
 		_list.filesToProcess.end(),
@@ -1195,23 +1215,32 @@ bool SendFilesBox::addFiles(Ui::PreparedList list) {
 	return true;
 }
 
-void SendFilesBox::addPreparedAsyncFile(Ui::PreparedFile &&file) {
+void SendFilesBox::addPreparedAsyncFile(
+		uint64 id,
+		Ui::PreparedFile &&file) {
 	Expects(file.information != nullptr);
+	Expects(id >= _preparingFirstId
+		&& id < _preparingFirstId + _preparing.size());
 
-	_preparing = false;
+	_preparing[id - _preparingFirstId] = std::move(file);
 	const auto count = int(_list.files.size());
-	addFile(std::move(file));
 	enqueueNextPrepare();
 	if (_list.files.size() > count) {
 		refreshAllAfterChanges(count);
+	} else if (_preparing.empty() && _list.files.empty()) {
+		// Every file was rejected, there is nothing left to send.
+		closeBox();
+		return;
 	}
-	if (!_preparing && _whenReadySend) {
+	if (_preparing.empty() && _whenReadySend) {
 		_whenReadySend();
 	}
 }
 
 void SendFilesBox::addFile(Ui::PreparedFile &&file) {
-	// canBeSentInSlowmode checks for non empty filesToProcess.
+	// canBeSentInSlowmode counts files in filesToProcess.
+	// Files are checked one by one when prepared, while the slowmode
+	// rejection is shown once for each batch of added files.
 	auto saved = base::take(_list.filesToProcess);
 	_list.files.push_back(std::move(file));
 	const auto lastOk = [&] {
@@ -1219,9 +1248,13 @@ void SendFilesBox::addFile(Ui::PreparedFile &&file) {
 		if (_limits & SendFilesAllow::OnlyOne) {
 			way.setGroupFiles(true);
 			if (!_list.canBeSentInSlowmode()) {
+				if (!std::exchange(_slowmodeToastShown, true)) {
+					showToast(tr::lng_slowmode_no_many(tr::now));
+				}
 				return false;
 			}
-		} else if (!checkWithWay(way)) {
+		}
+		if (!checkWithWay(way)) {
 			return false;
 		}
 		_sendWay = way;
@@ -1406,7 +1439,7 @@ void SendFilesBox::send(
 		&& !options.scheduled) {
 		return sendScheduled();
 	}
-	if (_preparing) {
+	if (!_preparing.empty()) {
 		_whenReadySend = [=] {
 			send(options, ctrlShiftEnter);
 		};
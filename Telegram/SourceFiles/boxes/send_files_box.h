@@ -199,6 +199,7 @@ private:
 
 	void preparePreview();
 	void generatePreviewFrom(int fromBlock);
+	void refreshPreparingPlaceholder();
 
 	void send(Api::SendOptions options, bool ctrlShiftEnter = false);
 	void sendSilent();
@@ -222,7 +223,7 @@ private:
 	void refreshAllAfterChanges(int fromItem, Fn<void()> perform = nullptr);
 
 	void enqueueNextPrepare();
-	void addPreparedAsyncFile(Ui::PreparedFile &&file);
+	void addPreparedAsyncFile(uint64 id, Ui::PreparedFile &&file);
 
 	const std::shared_ptr<ChatHelpers::Show> _show;
 	const style::ComposeControls &_st;
@@ -261,7 +262,12 @@ private:
 	QPointer<Ui::VerticalLayout> _inner;
 	std::vector<Block> _blocks;
 	Fn<void()> _whenReadySend;
-	bool _preparing = false;
+
+	// Files in the order they were added, nullopt while in preparation.
+	std::deque<std::optional<Ui::PreparedFile>> _preparing;
+	uint64 _preparingFirstId = 0;
+	base::unique_qptr<Ui::FlatLabel> _preparingPlaceholder;
+	bool _slowmodeToastShown = false;
 
 	base::unique_qptr<Ui::PopupMenu> _menu;
 
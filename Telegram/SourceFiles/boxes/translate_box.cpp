@@ -13,6 +13,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/ui_integration.h"
 #include "data/data_peer.h"
 #include "data/data_session.h"
+#include "data/data_translations.h"
 #include "history/history.h"
 #include "lang/lang_instance.h"
 #include "lang/lang_keys.h"
@@ -230,9 +231,8 @@ void TranslateBox(
 		loading->hide(anim::type::instant);
 	};
 
-	const auto send = [=](LanguageId to) {
-		loading->show(anim::type::instant);
-		translated->hide(anim::type::instant);
+	const auto itemId = msgId ? FullMsgId(peer->id, msgId) : FullMsgId();
+	const auto request = [=](LanguageId to) {
 		state->api.request(MTPmessages_TranslateText(
 			MTP_flags(flags),
 			msgId ? peer->input : MTP_inputPeerEmpty(),
@@ -255,18 +255,41 @@ void TranslateBox(
 				showText(
 					Ui::Text::Italic(tr::lng_translate_box_error(tr::now)));
 			} else {
-				showText(TextWithEntities{
+				auto text = TextWithEntities{
 					.text = qs(list.front().data().vtext()),
 					.entities = Api::EntitiesFromMTP(
 						&peer->session(),
 						list.front().data().ventities().v),
-				});
+				};
+				if (const auto item = peer->owner().message(itemId)) {
+					Data::SaveCachedTranslation(item, to, text);
+				}
+				showText(std::move(text));
 			}
 		}).fail([=](const MTP::Error &error) {
 			showText(
 				Ui::Text::Italic(tr::lng_translate_box_error(tr::now)));
 		}).send();
 	};
+	const auto send = [=](LanguageId to) {
+		loading->show(anim::type::instant);
+		translated->hide(anim::type::instant);
+		const auto item = itemId ? peer->owner().message(itemId) : nullptr;
+		if (!item) {
+			request(to);
+			return;
+		}
+		Data::LoadCachedTranslation(item, to, crl::guard(box, [=](
+				TextWithEntities &&text) {
+			if (state->to.current() != to) {
+				return;
+			} else if (text.empty()) {
+				request(to);
+			} else {
+				showText(std::move(text));
+			}
+		}));
+	};
 	state->to.value() | rpl::start_with_next(send, box->lifetime());
 
 	box->addLeftButton(tr::lng_settings_language(), [=] {
@@ -26,6 +26,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "chat_helpers/stickers_lottie.h"
 #include "history/view/media/history_view_sticker.h"
 #include "lottie/lottie_single_player.h"
+#include "storage/storage_cache_lookups.h"
 #include "apiwrap.h"
 #include "styles/style_chat.h"
 
@@ -284,7 +285,9 @@ std::unique_ptr<Lottie::SinglePlayer> EmojiPack::effectPlayer(
 	const auto get = [=](int i, FnMut<void(QByteArray &&cached)> handler) {
 		document->owner().cacheBigFile().get(
 			{ key.high, key.low + i },
-			std::move(handler));
+			Storage::CountBigFileLookup(
+				document->owner().cacheLookups(),
+				std::move(handler)));
 	};
 	const auto weak = base::make_weak(&document->session());
 	const auto put = [=](int i, QByteArray &&cached) {
@@ -16,15 +16,25 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_file_origin.h"
 #include "storage/cache/storage_cache_database.h"
 #include "history/view/media/history_view_media_common.h"
+#include "media/clip/media_clip_frames_cache.h"
 #include "media/clip/media_clip_reader.h"
 #include "ui/effects/path_shift_gradient.h"
 #include "ui/painter.h"
 #include "main/main_session.h"
+#include "storage/storage_cache_lookups.h"
 
 namespace ChatHelpers {
 namespace {
 
 constexpr auto kDontCacheLottieAfterArea = 512 * 512;
+constexpr auto kWebmFramesReplacementsTag = uint8(0x0E);
+
+using WebmFramesId = std::tuple<uint64, uint64, uint64>;
+
+[[nodiscard]] base::flat_set<WebmFramesId> &WebmFramesPreparing() {
+	static auto result = base::flat_set<WebmFramesId>();
+	return result;
+}
 
 } // namespace
 
@@ -32,6 +42,51 @@ uint8 LottieCacheKeyShift(uint8 replacementsTag, StickerLottieSize sizeTag) {
 	return ((replacementsTag << 4) & 0xF0) | (uint8(sizeTag) & 0x0F);
 }
 
+Media::Clip::FramesCacheDescriptor WebmFramesCacheFromDocument(
+		not_null<Data::DocumentMedia*> media,
+		StickerLottieSize sizeTag,
+		QSize box) {
+	const auto document = media->owner();
+	const auto baseKey = document->bigFileBaseCacheKey();
+	if (!baseKey || box.width() * box.height() > kDontCacheLottieAfterArea) {
+		return {};
+	}
+	const auto key = Storage::Cache::Key{
+		baseKey.high,
+		baseKey.low + LottieCacheKeyShift(
+			kWebmFramesReplacementsTag,
+			sizeTag),
+	};
+	const auto session = &document->session();
+	const auto get = [=](FnMut<void(QByteArray &&cached)> handler) {
+		session->data().cacheBigFile().get(
+			key,
+			Storage::CountBigFileLookup(
+				session->data().cacheLookups(),
+				std::move(handler)));
+	};
+	const auto weak = base::make_weak(session);
+	const auto id = WebmFramesId(session->uniqueId(), key.high, key.low);
+	const auto put = [=](QByteArray &&cached) {
+		crl::on_main([=, data = std::move(cached)]() mutable {
+			WebmFramesPreparing().remove(id);
+			if (data.isEmpty()) {
+				return;
+			} else if (const auto strong = weak.get()) {
+				strong->data().cacheBigFile().put(
+					key,
+					Storage::Cache::Database::TaggedValue(
+						std::move(data),
+						Data::kWebmFramesCacheTag));
+			}
+		});
+	};
+	const auto startPreparing = [=] {
+		return WebmFramesPreparing().emplace(id).second;
+	};
+	return { .get = get, .put = put, .startPreparing = startPreparing };
+}
+
 template <typename Method>
 auto LottieCachedFromContent(
 		Method &&method,
@@ -47,7 +102,9 @@ auto LottieCachedFromContent(
 	const auto get = [=](FnMut<void(QByteArray &&cached)> handler) {
 		session->data().cacheBigFile().get(
 			key,
-			std::move(handler));
+			Storage::CountBigFileLookup(
+				session->data().cacheLookups(),
+				std::move(handler)));
 	};
 	const auto weak = base::make_weak(session);
 	const auto put = [=](QByteArray &&cached) {
@@ -21,6 +21,7 @@ struct Key;
 namespace Media::Clip {
 class ReaderPointer;
 enum class Notification;
+struct FramesCacheDescriptor;
 } // namespace Media::Clip
 
 namespace Lottie {
@@ -70,6 +71,11 @@ enum class StickerLottieSize : uint8 {
 	uint8 replacementsTag,
 	StickerLottieSize sizeTag);
 
+[[nodiscard]] Media::Clip::FramesCacheDescriptor WebmFramesCacheFromDocument(
+	not_null<Data::DocumentMedia*> media,
+	StickerLottieSize sizeTag,
+	QSize box);
+
 [[nodiscard]] std::unique_ptr<Lottie::SinglePlayer> LottiePlayerFromDocument(
 	not_null<Data::DocumentMedia*> media,
 	StickerLottieSize sizeTag,
@@ -22,6 +22,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/timer.h"
 #include "base/unixtime.h"
 #include "core/core_settings.h"
+#include "core/core_tracing.h"
 #include "core/update_checker.h"
 #include "core/shortcuts.h"
 #include "core/sandbox.h"
@@ -237,10 +238,14 @@ Application::~Application() {
 
 	ThirdParty::finish();
 
+	Tracing::Finish();
+
 	Instance = nullptr;
 }
 
 void Application::run() {
+	Tracing::Start();
+
 	style::internal::StartFonts();
 
 	ThirdParty::start();
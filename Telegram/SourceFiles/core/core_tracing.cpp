@@ -0,0 +1,160 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "core/core_tracing.h"
+
+#include "base/options.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+
+#include <mutex>
+
+namespace Core::Tracing {
+namespace {
+
+constexpr auto kMaxEvents = 1 << 18;
+
+base::options::toggle OptionHotPathTracing({
+	.id = kOptionHotPathTracing,
+	.name = "Trace hot paths",
+	.description = "Record timings of painting, updates handling, "
+		"network and media decoding. The trace is saved in Chrome trace "
+		"format to DebugLogs/trace.json on exit. Requires restart.",
+	.restartRequired = true,
+});
+
+struct Event {
+	const char *name = nullptr;
+	crl::profile_time start = 0;
+	int64 value = 0;
+	int thread = 0;
+	bool counter = false;
+};
+
+struct State {
+	std::mutex mutex;
+	std::vector<Event> events;
+	int next = 0;
+	std::atomic<int> threads = 0;
+};
+
+[[nodiscard]] State &Instance() {
+	static auto result = State();
+	return result;
+}
+
+[[nodiscard]] int ThreadIndex() {
+	thread_local const auto result = ++Instance().threads;
+	return result;
+}
+
+void Add(Event &&event) {
+	event.thread = ThreadIndex();
+
+	auto &state = Instance();
+	auto lock = std::lock_guard(state.mutex);
+	if (state.events.size() < kMaxEvents) {
+		state.events.push_back(std::move(event));
+	} else {
+		state.events[state.next] = std::move(event);
+		state.next = (state.next + 1) % kMaxEvents;
+	}
+}
+
+} // namespace
+
+const char kOptionHotPathTracing[] = "hot-path-tracing";
+
+namespace details {
+
+std::atomic<bool> Enabled = false;
+
+void AddZone(
+		const char *name,
+		crl::profile_time start,
+		crl::profile_time duration) {
+	Add({ .name = name, .start = start, .value = duration });
+}
+
+void AddCounter(const char *name, int64 value) {
+	Add({
+		.name = name,
+		.start = crl::profile(),
+		.value = value,
+		.counter = true,
+	});
+}
+
+} // namespace details
+
+void Start() {
+	if (OptionHotPathTracing.value()) {
+		Instance().events.reserve(kMaxEvents);
+		details::Enabled = true;
+	}
+}
+
+void Finish() {
+	if (!Enabled()) {
+		return;
+	}
+	details::Enabled = false;
+
+	const auto folder = cWorkingDir() + u"DebugLogs"_q;
+	QDir().mkpath(folder);
+	ExportChromeTrace(folder + u"/trace.json"_q);
+}
+
+bool ExportChromeTrace(const QString &path) {
+	auto events = std::vector<Event>();
+	{
+		auto &state = Instance();
+		auto lock = std::lock_guard(state.mutex);
+		events = state.events;
+		std::rotate(
+			begin(events),
+			begin(events) + state.next,
+			end(events));
+	}
+
+	auto f = QFile(path);
+	if (!f.open(QIODevice::WriteOnly)) {
+		LOG(("Tracing Error: Could not open '%1' for writing.").arg(path));
+		return false;
+	}
+	auto result = QByteArray();
+	result.reserve(int(events.size()) * 96 + 32);
+	result.append("{\"traceEvents\":[");
+	auto first = true;
+	for (const auto &event : events) {
+		if (!first) {
+			result.append(",\n");
+		}
+		first = false;
+		result.append("{\"name\":\"").append(event.name);
+		result.append("\",\"pid\":1,\"tid\":");
+		result.append(QByteArray::number(event.thread));
+		result.append(",\"ts\":").append(QByteArray::number(event.start));
+		if (event.counter) {
+			result.append(",\"ph\":\"C\",\"args\":{\"value\":");
+			result.append(QByteArray::number(event.value)).append("}}");
+		} else {
+			result.append(",\"ph\":\"X\",\"dur\":");
+			result.append(QByteArray::number(event.value)).append('}');
+		}
+	}
+	result.append("]}\n");
+	if (f.write(result) != result.size()) {
+		LOG(("Tracing Error: Could not write '%1'.").arg(path));
+		return false;
+	}
+	LOG(("Tracing: Saved %1 events to '%2'.").arg(events.size()).arg(path));
+	return true;
+}
+
+} // namespace Core::Tracing
@@ -0,0 +1,64 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include <atomic>
+
+namespace Core::Tracing {
+
+extern const char kOptionHotPathTracing[];
+
+namespace details {
+
+extern std::atomic<bool> Enabled;
+
+void AddZone(
+	const char *name,
+	crl::profile_time start,
+	crl::profile_time duration);
+void AddCounter(const char *name, int64 value);
+
+} // namespace details
+
+[[nodiscard]] inline bool Enabled() {
+	return details::Enabled.load(std::memory_order_relaxed);
+}
+
+// Names must be string literals, they are stored without copying.
+class Zone final {
+public:
+	explicit Zone(const char *name)
+	: _name(Enabled() ? name : nullptr)
+	, _start(_name ? crl::profile() : 0) {
+	}
+	Zone(const Zone &other) = delete;
+	Zone &operator=(const Zone &other) = delete;
+	~Zone() {
+		if (_name) {
+			details::AddZone(_name, _start, crl::profile() - _start);
+		}
+	}
+
+private:
+	const char *_name = nullptr;
+	crl::profile_time _start = 0;
+
+};
+
+inline void Counter(const char *name, int64 value) {
+	if (Enabled()) {
+		details::AddCounter(name, value);
+	}
+}
+
+void Start();
+void Finish();
+
+bool ExportChromeTrace(const QString &path);
+
+} // namespace Core::Tracing
@@ -21,6 +21,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/local_url_handlers.h"
 #include "core/update_checker.h"
 #include "core/deadlock_detector.h"
+#include "core/stall_detector.h"
+#include "ayu/ayu_settings.h"
 #include "base/timer.h"
 #include "base/concurrent_timer.h"
 #include "base/invoke_queued.h"
@@ -214,6 +216,13 @@ void Sandbox::launchApplication() {
 		installNativeEventFilter(this);
 
 		_application->run();
+
+		// The thresholds are read with the settings in Application::run.
+		if (StallDetector::Enabled()) {
+			const auto &settings = AyuSettings::getInstance();
+			_stallWatchdog = std::make_unique<StallDetector::Watchdog>(
+				StallDetector::ValidThresholds(settings.stallThresholdsMs));
+		}
 	});
 }
 
@@ -649,6 +658,7 @@ void Sandbox::closeApplication() {
 	}
 	SetLaunchState(LaunchState::QuitProcessed);
 
+	_stallWatchdog = nullptr;
 	_application = nullptr;
 
 	_localServer.close();
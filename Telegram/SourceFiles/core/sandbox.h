@@ -22,6 +22,10 @@ namespace Core {
 class UpdateChecker;
 class Application;
 
+namespace StallDetector {
+class Watchdog;
+} // namespace StallDetector
+
 class Sandbox final
 	: public QApplication
 	, private QAbstractNativeEventFilter {
@@ -132,6 +136,7 @@ private:
 	rpl::event_stream<> _widgetUpdateRequests;
 
 	std::unique_ptr<QThread> _deadlockDetector;
+	std::unique_ptr<StallDetector::Watchdog> _stallWatchdog;
 
 };
 
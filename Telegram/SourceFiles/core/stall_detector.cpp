@@ -0,0 +1,271 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "core/stall_detector.h"
+
+#include "base/options.h"
+
+#include <QtCore/QTextStream>
+
+#include <atomic>
+
+#ifdef Q_OS_LINUX
+#include <execinfo.h>
+#include <pthread.h>
+#include <signal.h>
+#endif // Q_OS_LINUX
+
+namespace Core::StallDetector {
+namespace {
+
+constexpr auto kCheckInterval = crl::time(10);
+constexpr auto kMaxUniqueSamples = 512;
+constexpr auto kMaxThresholds = 8;
+
+base::options::toggle OptionStallWatchdog({
+	.id = kOptionStallWatchdog,
+	.name = "Main thread stall watchdog",
+	.description = "Detect main thread stalls longer than the "
+		"stallThresholdsMs values from tdata/ayu_settings.json (50 ms and "
+		"250 ms by default), sample the main thread stack while they last "
+		"and save the report to DebugLogs/stalls.txt on exit.",
+	.restartRequired = true,
+});
+
+#ifdef Q_OS_LINUX
+
+constexpr auto kMaxFrames = 64;
+
+// Frames of the signal handler and the signal trampoline.
+constexpr auto kSkipFrames = 2;
+
+pthread_t MainThread;
+void *SampleFrames[kMaxFrames];
+std::atomic<int> SampleSize = 0;
+std::atomic<bool> SampleReady = false;
+
+void SampleHandler(int signum) {
+	const auto saved = errno;
+	SampleSize = backtrace(SampleFrames, kMaxFrames);
+	SampleReady = true;
+	errno = saved;
+}
+
+void InstallSampleHandler() {
+	MainThread = pthread_self();
+
+	// The first backtrace() call may load libgcc and allocate,
+	// so make it here and not inside the signal handler.
+	void *warmup[1];
+	backtrace(warmup, 1);
+
+	struct sigaction sigact;
+	sigact.sa_handler = SampleHandler;
+	sigemptyset(&sigact.sa_mask);
+	sigact.sa_flags = SA_RESTART;
+	sigaction(SIGPROF, &sigact, nullptr);
+}
+
+[[nodiscard]] std::vector<void*> SampleMainThread() {
+	SampleReady = false;
+	if (pthread_kill(MainThread, SIGPROF) != 0) {
+		return {};
+	}
+	for (auto i = 0; i != 10 && !SampleReady; ++i) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	if (!SampleReady) {
+		return {};
+	}
+	const auto size = SampleSize.load();
+	return (size > kSkipFrames)
+		? std::vector<void*>(
+			SampleFrames + kSkipFrames,
+			SampleFrames + size)
+		: std::vector<void*>();
+}
+
+[[nodiscard]] QStringList Symbolize(const std::vector<void*> &frames) {
+	auto result = QStringList();
+	const auto symbols = backtrace_symbols(
+		frames.data(),
+		int(frames.size()));
+	if (!symbols) {
+		return result;
+	}
+	for (auto i = 0, count = int(frames.size()); i != count; ++i) {
+		result.push_back(QString::fromLocal8Bit(symbols[i]));
+	}
+	free(symbols);
+	return result;
+}
+
+#else // Q_OS_LINUX
+
+void InstallSampleHandler() {
+}
+
+[[nodiscard]] std::vector<void*> SampleMainThread() {
+	return {};
+}
+
+[[nodiscard]] QStringList Symbolize(const std::vector<void*> &frames) {
+	return {};
+}
+
+#endif // Q_OS_LINUX
+
+} // namespace
+
+const char kOptionStallWatchdog[] = "stall-watchdog";
+
+struct Watchdog::Heartbeat {
+	std::atomic<crl::time> sent = 0;
+	std::atomic<crl::time> answered = 0;
+};
+
+bool Enabled() {
+	return OptionStallWatchdog.value();
+}
+
+std::vector<crl::time> ValidThresholds(const std::vector<int> &milliseconds) {
+	auto result = milliseconds | ranges::views::filter([](int value) {
+		return value > 0;
+	}) | ranges::views::transform([](int value) {
+		return crl::time(value);
+	}) | ranges::to_vector;
+	ranges::sort(result);
+	result.erase(ranges::unique(result), end(result));
+	if (result.size() > kMaxThresholds) {
+		result.resize(kMaxThresholds);
+	}
+	return result.empty()
+		? std::vector<crl::time>{ 50, 250 }
+		: result;
+}
+
+Watchdog::Watchdog(std::vector<crl::time> thresholds)
+: _thresholds(std::move(thresholds))
+, _heartbeat(std::make_shared<Heartbeat>())
+, _stalls(_thresholds.size()) {
+	Expects(!_thresholds.empty());
+	Expects(ranges::is_sorted(_thresholds));
+
+	InstallSampleHandler();
+	_thread = std::thread([=] { run(); });
+}
+
+Watchdog::~Watchdog() {
+	{
+		auto lock = std::unique_lock(_mutex);
+		_stopping = true;
+	}
+	_variable.notify_one();
+	_thread.join();
+
+	writeReport();
+}
+
+void Watchdog::run() {
+	auto lock = std::unique_lock(_mutex);
+	while (!_stopping) {
+		_variable.wait_for(lock, std::chrono::milliseconds(kCheckInterval));
+		if (_stopping) {
+			break;
+		}
+		lock.unlock();
+		check();
+		lock.lock();
+	}
+}
+
+void Watchdog::check() {
+	const auto sent = _heartbeat->sent.load();
+	if (!sent) {
+		if (_stallStarted) {
+			finishStall(_heartbeat->answered.load() - _stallStarted);
+			_stallStarted = 0;
+		}
+		_heartbeat->sent = crl::now();
+		crl::on_main([heartbeat = _heartbeat] {
+			heartbeat->answered = crl::now();
+			heartbeat->sent = 0;
+		});
+		return;
+	}
+	if (crl::now() - sent >= _thresholds.front()) {
+		_stallStarted = sent;
+		sample();
+	}
+}
+
+void Watchdog::sample() {
+	auto frames = SampleMainThread();
+	if (frames.empty()) {
+		return;
+	}
+	const auto i = _samples.find(frames);
+	if (i != end(_samples)) {
+		++i->second;
+	} else if (_samples.size() < kMaxUniqueSamples) {
+		_samples.emplace(std::move(frames), 1);
+	}
+}
+
+void Watchdog::finishStall(crl::time duration) {
+	for (auto i = 0, count = int(_thresholds.size()); i != count; ++i) {
+		if (duration < _thresholds[i]) {
+			break;
+		}
+		auto &stalls = _stalls[i];
+		++stalls.count;
+		accumulate_max(stalls.longest, duration);
+	}
+	if (duration >= _thresholds.back()) {
+		LOG(("Stall: Main thread was blocked for %1 ms.").arg(duration));
+	}
+}
+
+void Watchdog::writeReport() const {
+	if (ranges::all_of(_stalls, [](Stalls s) { return !s.count; })) {
+		return;
+	}
+	const auto folder = cWorkingDir() + u"DebugLogs"_q;
+	QDir().mkpath(folder);
+	auto f = QFile(folder + u"/stalls.txt"_q);
+	if (!f.open(QIODevice::WriteOnly | QIODevice::Text)) {
+		return;
+	}
+	auto stream = QTextStream(&f);
+	stream << "Main thread stalls:\n";
+	for (auto i = 0, count = int(_thresholds.size()); i != count; ++i) {
+		stream
+			<< ">= " << _thresholds[i] << " ms: "
+			<< _stalls[i].count << " (longest "
+			<< _stalls[i].longest << " ms)\n";
+	}
+
+	auto sorted = std::vector<std::pair<int, const std::vector<void*>*>>();
+	sorted.reserve(_samples.size());
+	for (const auto &[frames, count] : _samples) {
+		sorted.emplace_back(count, &frames);
+	}
+	ranges::sort(sorted, ranges::greater(), [](const auto &pair) {
+		return pair.first;
+	});
+	if (!sorted.empty()) {
+		stream << "\nSampled stacks, most frequent first:\n";
+	}
+	for (const auto &[count, frames] : sorted) {
+		stream << "\n" << count << " samples:\n";
+		for (const auto &line : Symbolize(*frames)) {
+			stream << "  " << line << "\n";
+		}
+	}
+}
+
+} // namespace Core::StallDetector
@@ -0,0 +1,60 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace Core::StallDetector {
+
+extern const char kOptionStallWatchdog[];
+
+[[nodiscard]] bool Enabled();
+
+// Sorted positive thresholds, the default ones if none are valid.
+[[nodiscard]] std::vector<crl::time> ValidThresholds(
+	const std::vector<int> &milliseconds);
+
+// Watches the main thread event loop from a separate thread. Stalls
+// longer than each of the thresholds are counted, and while a stall lasts
+// the main thread stack is sampled (on Linux, using a signal). The
+// aggregated report is saved to DebugLogs/stalls.txt on destruction.
+class Watchdog final {
+public:
+	explicit Watchdog(std::vector<crl::time> thresholds);
+	~Watchdog();
+
+private:
+	struct Heartbeat;
+	struct Stalls {
+		int count = 0;
+		crl::time longest = 0;
+	};
+
+	void run();
+	void check();
+	void sample();
+	void finishStall(crl::time duration);
+	void writeReport() const;
+
+	const std::vector<crl::time> _thresholds;
+	const std::shared_ptr<Heartbeat> _heartbeat;
+
+	std::vector<Stalls> _stalls;
+	std::map<std::vector<void*>, int> _samples;
+	crl::time _stallStarted = 0;
+
+	std::mutex _mutex;
+	std::condition_variable _variable;
+	bool _stopping = false;
+	std::thread _thread;
+
+};
+
+} // namespace Core::StallDetector
@@ -38,6 +38,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/view/media/history_view_gif.h"
 #include "window/window_session_controller.h"
 #include "storage/cache/storage_cache_database.h"
+#include "storage/storage_cache_quotas.h"
 #include "ui/boxes/confirm_box.h"
 #include "ui/image/image.h"
 #include "ui/text/text_utilities.h"
@@ -92,6 +93,25 @@ void UpdateStickerSetIdentifier(
 	});
 }
 
+// Mapping a file someone else truncates crashes with SIGBUS on access,
+// so only files in the app temp folder, that is not shown to the user,
+// are mapped. Downloads are user-visible and are read the usual way.
+[[nodiscard]] bool IsAppOwnedFile(
+		not_null<Main::Session*> session,
+		const QString &path) {
+	const auto folder = session->local().tempDirectory();
+	if (folder.isEmpty()) {
+		return false;
+	}
+	const auto absolute = QFileInfo(path).absoluteFilePath();
+	const auto prefix = QDir::cleanPath(
+		QFileInfo(folder).absoluteFilePath()) + '/';
+	const auto sensitivity = (Platform::IsWindows() || Platform::IsMac())
+		? Qt::CaseInsensitive
+		: Qt::CaseSensitive;
+	return absolute.startsWith(prefix, sensitivity);
+}
+
 } // namespace
 
 QString FileNameUnsafe(
@@ -476,6 +496,7 @@ void DocumentData::setDataAndCache(const QByteArray &data) {
 		media->setBytes(data);
 	}
 	if (saveToCache() && data.size() <= Storage::kMaxFileInMemory) {
+		owner().cacheQuotas().registerPut(cacheKey(), cacheTag(), data.size());
 		owner().cache().put(
 			cacheKey(),
 			Storage::Cache::Database::TaggedValue(
@@ -1375,7 +1396,9 @@ auto DocumentData::createStreamingLoader(
 		if (media && !media->bytes().isEmpty()) {
 			return Media::Streaming::MakeBytesLoader(media->bytes());
 		} else if (!location.isEmpty() && location.accessEnable()) {
-			auto result = Media::Streaming::MakeFileLoader(location.name());
+			auto result = Media::Streaming::MakeFileLoader(
+				location.name(),
+				IsAppOwnedFile(&session(), location.name()));
 			location.accessDisable();
 			return result;
 		}
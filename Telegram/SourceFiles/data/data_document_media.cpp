@@ -27,6 +27,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "storage/file_download.h"
 #include "ui/chat/attach/attach_prepare.h"
 #include "ui/image/image.h"
+#include "storage/storage_cache_lookups.h"
+#include "storage/storage_cache_quotas.h"
 
 #include <QtCore/QBuffer>
 #include <QtGui/QImageReader>
@@ -458,8 +460,13 @@ void DocumentMedia::GenerateGoodThumbnail(
 			if (const auto active = document->activeMediaView()) {
 				active->setGoodThumbnail(result);
 			}
+			const auto key = document->goodThumbnailCacheKey();
+			document->owner().cacheQuotas().registerPut(
+				key,
+				kImageCacheTag,
+				cache.size());
 			document->owner().cache().put(
-				document->goodThumbnailCacheKey(),
+				key,
 				Storage::Cache::Database::TaggedValue{
 					base::duplicate(cache),
 					kImageCacheTag });
@@ -484,7 +491,9 @@ void DocumentMedia::ReadOrGenerateThumbnail(
 
 	const auto guard = base::make_weak(&document->session());
 	const auto active = document->activeMediaView();
+	const auto lookups = document->owner().cacheLookups();
 	const auto got = [=](QByteArray value) {
+		lookups->registerLookup(kImageCacheTag, !value.isEmpty());
 		if (value.isEmpty()) {
 			const auto bytes = active ? active->bytes() : QByteArray();
 			crl::on_main(guard, [=] {
@@ -495,6 +504,8 @@ void DocumentMedia::ReadOrGenerateThumbnail(
 				auto image = Images::Read({ .content = value }).image;
 				crl::on_main(guard, [=, image = std::move(image)]() mutable {
 					document->setGoodThumbnailChecked(true);
+					document->owner().cacheQuotas().registerUse(
+						document->goodThumbnailCacheKey());
 					if (const auto active = document->activeMediaView()) {
 						active->setGoodThumbnail(std::move(image));
 					}
@@ -503,6 +514,8 @@ void DocumentMedia::ReadOrGenerateThumbnail(
 		} else {
 			crl::on_main(guard, [=] {
 				document->setGoodThumbnailChecked(true);
+				document->owner().cacheQuotas().registerUse(
+					document->goodThumbnailCacheKey());
 			});
 		}
 	};
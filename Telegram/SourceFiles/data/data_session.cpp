@@ -18,6 +18,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "api/api_user_names.h"
 #include "core/application.h"
 #include "core/core_settings.h"
+#include "core/core_tracing.h"
 #include "core/mime_type.h" // Core::IsMimeSticker
 #include "core/crash_reports.h" // CrashReports::SetAnnotation
 #include "ui/image/image.h"
@@ -33,6 +34,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/view/history_view_element.h"
 #include "inline_bots/inline_bot_layout_item.h"
 #include "storage/storage_account.h"
+#include "storage/storage_cache_lookups.h"
+#include "storage/storage_cache_quotas.h"
 #include "storage/storage_encrypted_file.h"
 #include "media/player/media_player_instance.h" // instance()->play()
 #include "media/audio/media_audio.h"
@@ -94,6 +97,11 @@ namespace {
 
 using ViewElement = HistoryView::Element;
 
+// AyuGram saveDeletedMessages
+using KeptDeletedMessages = base::flat_map<
+	not_null<History*>,
+	std::vector<not_null<HistoryItem*>>>;
+
 // s: box 100x100
 // m: box 320x320
 // x: box 800x800
@@ -251,6 +259,11 @@ Session::Session(not_null<Main::Session*> session)
 , _bigFileCache(Core::App().databases().get(
 	_session->local().cacheBigFilePath(),
 	_session->local().cacheBigFileSettings()))
+, _cacheLookups(std::make_shared<Storage::CacheLookups>())
+, _cacheQuotas(std::make_unique<Storage::CacheQuotas>(
+	&*_cache,
+	CacheQuotasIndexKey(),
+	_session->local().cacheTagQuotas()))
 , _chatsList(
 	session,
 	FilterId(),
@@ -289,6 +302,7 @@ Session::Session(not_null<Main::Session*> session)
 	}
 
 	setupMigrationViewer();
+	setupCacheQuotasPinned();
 	setupChannelLeavingViewer();
 	setupPeerNameViewer();
 	setupUserIsContactViewer();
@@ -1071,6 +1085,7 @@ not_null<PeerData*> Session::processChat(const MTPChat &data) {
 }
 
 UserData *Session::processUsers(const MTPVector<MTPUser> &data) {
+	const auto zone = Core::Tracing::Zone("Data::Session::processUsers");
 	auto result = (UserData*)nullptr;
 	for (const auto &user : data.v) {
 		result = processUser(user);
@@ -1079,6 +1094,7 @@ UserData *Session::processUsers(const MTPVector<MTPUser> &data) {
 }
 
 PeerData *Session::processChats(const MTPVector<MTPChat> &data) {
+	const auto zone = Core::Tracing::Zone("Data::Session::processChats");
 	auto result = (PeerData*)nullptr;
 	for (const auto &chat : data.v) {
 		result = processChat(chat);
@@ -1343,6 +1359,14 @@ Storage::Cache::Database &Session::cacheBigFile() {
 	return *_bigFileCache;
 }
 
+std::shared_ptr<Storage::CacheLookups> Session::cacheLookups() const {
+	return _cacheLookups;
+}
+
+Storage::CacheQuotas &Session::cacheQuotas() const {
+	return *_cacheQuotas;
+}
+
 void Session::suggestStartExport(TimeId availableAt) {
 	_exportAvailableAt = availableAt;
 	suggestStartExport();
@@ -1428,6 +1452,25 @@ void Session::setupMigrationViewer() {
 	}, _lifetime);
 }
 
+void Session::setupCacheQuotasPinned() {
+	_stickers->updated(
+		StickersType::Stickers
+	) | rpl::start_with_next([=] {
+		auto keys = base::flat_set<Storage::Cache::Key>();
+		const auto &sets = _stickers->sets();
+		for (const auto setId : _stickers->setsOrder()) {
+			const auto i = sets.find(setId);
+			if (i == end(sets)) {
+				continue;
+			}
+			for (const auto &document : i->second->stickers) {
+				keys.emplace(document->cacheKey());
+			}
+		}
+		_cacheQuotas->setPinned(std::move(keys));
+	}, _lifetime);
+}
+
 void Session::setupChannelLeavingViewer() {
 	session().changes().peerUpdates(
 		PeerUpdate::Flag::ChannelAmIn
@@ -2335,6 +2378,7 @@ proceed:
 void Session::processMessages(
 		const QVector<MTPMessage> &data,
 		NewMessageType type) {
+	const auto zone = Core::Tracing::Zone("Data::Session::processMessages");
 	auto indices = base::flat_map<uint64, int>();
 	for (int i = 0, l = data.size(); i != l; ++i) {
 		const auto &message = data[i];
@@ -2471,11 +2515,17 @@ void Session::processMessagesDeleted(
 	}
 
 	auto historiesToCheck = base::flat_set<not_null<History*>>();
+	auto keptDeleted = KeptDeletedMessages();
 	for (const auto &messageId : data) {
 		const auto i = list ? list->find(messageId.v) : Messages::iterator();
 		if (list && i != list->end()) {
-			const auto history = i->second->history();
-			i->second->destroy();
+			const auto item = i->second;
+			const auto history = item->history();
+			if (history->keepsDeletedMessage(item)) {
+				keptDeleted[history].push_back(item);
+				continue;
+			}
+			item->destroy();
 			if (!history->chatListMessageKnown()) {
 				historiesToCheck.emplace(history);
 			}
@@ -2483,6 +2533,9 @@ void Session::processMessagesDeleted(
 			affected->unknownMessageDeleted(messageId.v);
 		}
 	}
+	for (const auto &[history, items] : keptDeleted) {
+		history->markMessagesDeleted(items);
+	}
 	for (const auto &history : historiesToCheck) {
 		history->requestChatListMessage();
 	}
@@ -2490,15 +2543,23 @@ void Session::processMessagesDeleted(
 
 void Session::processNonChannelMessagesDeleted(const QVector<MTPint> &data) {
 	auto historiesToCheck = base::flat_set<not_null<History*>>();
+	auto keptDeleted = KeptDeletedMessages();
 	for (const auto &messageId : data) {
 		if (const auto item = nonChannelMessage(messageId.v)) {
 			const auto history = item->history();
+			if (history->keepsDeletedMessage(item)) {
+				keptDeleted[history].push_back(item);
+				continue;
+			}
 			item->destroy();
 			if (!history->chatListMessageKnown()) {
 				historiesToCheck.emplace(history);
 			}
 		}
 	}
+	for (const auto &[history, items] : keptDeleted) {
+		history->markMessagesDeleted(items);
+	}
 	for (const auto &history : historiesToCheck) {
 		history->requestChatListMessage();
 	}
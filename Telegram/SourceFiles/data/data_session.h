@@ -33,6 +33,11 @@ namespace Main {
 class Session;
 } // namespace Main
 
+namespace Storage {
+class CacheLookups;
+class CacheQuotas;
+} // namespace Storage
+
 namespace Ui {
 class BoxContent;
 } // namespace Ui
@@ -164,6 +169,9 @@ public:
 	[[nodiscard]] Storage::Cache::Database &cache();
 	[[nodiscard]] Storage::Cache::Database &cacheBigFile();
 
+	[[nodiscard]] std::shared_ptr<Storage::CacheLookups> cacheLookups() const;
+	[[nodiscard]] Storage::CacheQuotas &cacheQuotas() const;
+
 	[[nodiscard]] not_null<PeerData*> peer(PeerId id);
 	[[nodiscard]] not_null<PeerData*> peer(UserId id) = delete;
 	[[nodiscard]] not_null<UserData*> user(UserId id);
@@ -738,6 +746,7 @@ private:
 	void suggestStartExport();
 
 	void setupMigrationViewer();
+	void setupCacheQuotasPinned();
 	void setupChannelLeavingViewer();
 	void setupPeerNameViewer();
 	void setupUserIsContactViewer();
@@ -864,6 +873,8 @@ private:
 
 	Storage::DatabasePointer _cache;
 	Storage::DatabasePointer _bigFileCache;
+	const std::shared_ptr<Storage::CacheLookups> _cacheLookups;
+	const std::unique_ptr<Storage::CacheQuotas> _cacheQuotas;
 
 	TimeId _exportAvailableAt = 0;
 	QPointer<Ui::BoxContent> _exportSuggestion;
@@ -25,6 +25,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "media/streaming/media_streaming_reader.h"
 #include "storage/download_manager_mtproto.h"
 #include "storage/file_download.h" // kMaxFileInMemory
+#include "storage/storage_cache_lookups.h"
 #include "ui/text/text_utilities.h"
 
 namespace Data {
@@ -776,8 +777,10 @@ void StoryPreload::start() {
 			const auto key = video->bigFileBaseCacheKey();
 			if (key) {
 				const auto weak = base::make_weak(this);
-				video->owner().cacheBigFile().get(key, [weak](
+				const auto lookups = video->owner().cacheLookups();
+				video->owner().cacheBigFile().get(key, [=](
 						const QByteArray &result) {
+					lookups->registerBigFileLookup(!result.isEmpty());
 					if (!result.isEmpty()) {
 						crl::on_main([weak] {
 							if (const auto strong = weak.get()) {
@@ -71,7 +71,8 @@ template <typename Data>
 	}
 	auto result = std::make_shared<Reader>(
 		std::move(loader),
-		&_owner->cacheBigFile());
+		&_owner->cacheBigFile(),
+		_owner->cacheLookups());
 	if (!PruneDestroyedAndSet(readers, data, result)) {
 		readers.emplace_or_assign(data, result);
 	}
@@ -0,0 +1,179 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "data/data_translations.h"
+
+#include "data/data_session.h"
+#include "data/data_types.h"
+#include "history/history.h"
+#include "history/history_item.h"
+#include "history/history_item_components.h"
+#include "main/main_session.h"
+#include "storage/cache/storage_cache_database.h"
+#include "storage/storage_cache_lookups.h"
+#include "storage/storage_cache_quotas.h"
+
+#include <QtCore/QDataStream>
+
+namespace Data {
+namespace {
+
+constexpr auto kVersion = quint32(1);
+constexpr auto kMaxEntities = 16 * 1024;
+
+struct Description {
+	PeerId peer = 0;
+	MsgId msg = 0;
+	TimeId edited = 0;
+	QString to;
+};
+
+[[nodiscard]] Description Describe(
+		not_null<HistoryItem*> item,
+		LanguageId to) {
+	const auto edited = item->Get<HistoryMessageEdited>();
+	return {
+		.peer = item->history()->peer->id,
+		.msg = item->id,
+		.edited = edited ? edited->date : TimeId(),
+		.to = to.twoLetterCode(),
+	};
+}
+
+[[nodiscard]] Storage::Cache::Key KeyFor(const Description &description) {
+	return TranslationCacheKey(u"%1_%2_%3_%4"_q
+		.arg(description.peer.value)
+		.arg(description.msg.bare)
+		.arg(description.edited)
+		.arg(description.to));
+}
+
+void WriteDescription(QDataStream &stream, const Description &description) {
+	stream
+		<< quint64(description.peer.value)
+		<< qint64(description.msg.bare)
+		<< qint32(description.edited)
+		<< description.to;
+}
+
+[[nodiscard]] QByteArray Serialize(
+		const Description &description,
+		const TextWithEntities &text) {
+	auto result = QByteArray();
+	auto stream = QDataStream(&result, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_1);
+	stream << kVersion;
+	WriteDescription(stream, description);
+	stream << text.text << qint32(text.entities.size());
+	for (const auto &entity : text.entities) {
+		stream
+			<< qint32(entity.type())
+			<< qint32(entity.offset())
+			<< qint32(entity.length())
+			<< entity.data();
+	}
+	return (stream.status() == QDataStream::Ok) ? result : QByteArray();
+}
+
+[[nodiscard]] TextWithEntities Deserialize(
+		const Description &description,
+		const QByteArray &serialized) {
+	auto stream = QDataStream(serialized);
+	stream.setVersion(QDataStream::Qt_5_1);
+
+	auto version = quint32();
+	auto peer = quint64();
+	auto msg = qint64();
+	auto edited = qint32();
+	auto to = QString();
+	auto result = TextWithEntities();
+	auto count = qint32();
+	stream >> version >> peer >> msg >> edited >> to;
+	if (stream.status() != QDataStream::Ok
+		|| version != kVersion
+		|| peer != description.peer.value
+		|| msg != description.msg.bare
+		|| edited != description.edited
+		|| to != description.to) {
+		// Hash collision or an outdated format.
+		return {};
+	}
+	stream >> result.text >> count;
+	if (stream.status() != QDataStream::Ok
+		|| count < 0
+		|| count > kMaxEntities) {
+		return {};
+	}
+	result.entities.reserve(count);
+	for (auto i = 0; i != count; ++i) {
+		auto type = qint32();
+		auto offset = qint32();
+		auto length = qint32();
+		auto data = QString();
+		stream >> type >> offset >> length >> data;
+		if (stream.status() != QDataStream::Ok
+			|| offset < 0
+			|| length < 0
+			|| offset + length > result.text.size()) {
+			return {};
+		}
+		result.entities.push_back(
+			EntityInText(EntityType(type), offset, length, data));
+	}
+	return result;
+}
+
+} // namespace
+
+void LoadCachedTranslation(
+		not_null<HistoryItem*> item,
+		LanguageId to,
+		Fn<void(TextWithEntities &&text)> done) {
+	const auto session = &item->history()->session();
+	const auto description = Describe(item, to);
+	const auto lookups = session->data().cacheLookups();
+	const auto key = KeyFor(description);
+	session->data().cache().get(key, [=](
+			QByteArray &&value) {
+		auto text = value.isEmpty()
+			? TextWithEntities()
+			: Deserialize(description, value);
+		lookups->registerLookup(kTranslationCacheTag, !text.empty());
+		crl::on_main(session, [=, text = std::move(text)]() mutable {
+			if (!text.empty()) {
+				session->data().cacheQuotas().registerUse(key);
+			}
+			done(std::move(text));
+		});
+	});
+}
+
+void SaveCachedTranslation(
+		not_null<HistoryItem*> item,
+		LanguageId to,
+		const TextWithEntities &text) {
+	if (text.empty() || !item->isRegular()) {
+		return;
+	}
+	const auto description = Describe(item, to);
+	auto serialized = Serialize(description, text);
+	if (serialized.isEmpty()) {
+		return;
+	}
+	const auto key = KeyFor(description);
+	item->history()->owner().cacheQuotas().registerPut(
+		key,
+		kTranslationCacheTag,
+		serialized.size());
+	item->history()->owner().cache().put(
+		key,
+		Storage::Cache::Database::TaggedValue(
+			std::move(serialized),
+			kTranslationCacheTag));
+}
+
+} // namespace Data
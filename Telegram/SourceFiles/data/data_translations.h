@@ -0,0 +1,28 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "spellcheck/spellcheck_types.h"
+
+class HistoryItem;
+
+namespace Data {
+
+// Translations of messages are kept in the encrypted local cache,
+// keyed by the message, its edit date and the target language.
+// The callback is called on main with an empty text if nothing is found.
+void LoadCachedTranslation(
+	not_null<HistoryItem*> item,
+	LanguageId to,
+	Fn<void(TextWithEntities &&text)> done);
+void SaveCachedTranslation(
+	not_null<HistoryItem*> item,
+	LanguageId to,
+	const TextWithEntities &text);
+
+} // namespace Data
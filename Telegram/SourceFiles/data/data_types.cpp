@@ -22,6 +22,8 @@ constexpr auto kAudioAlbumThumbCacheTag = 0x0000000000000300ULL;
 constexpr auto kWebDocumentCacheTag = 0x0000020000000000ULL;
 constexpr auto kUrlCacheTag = 0x0000030000000000ULL;
 constexpr auto kGeoPointCacheTag = 0x0000040000000000ULL;
+constexpr auto kTranslationCacheKeyTag = 0x0000050000000000ULL;
+constexpr auto kCacheQuotasIndexKeyTag = 0x0000060000000000ULL;
 
 } // namespace
 
@@ -95,6 +97,24 @@ Storage::Cache::Key AudioAlbumThumbCacheKey(
 	};
 }
 
+Storage::Cache::Key TranslationCacheKey(const QString &description) {
+	const auto utf8 = description.toUtf8();
+	const auto hash = openssl::Sha256(bytes::make_span(utf8));
+	const auto bytes = bytes::make_span(hash);
+	const auto bytes1 = bytes.subspan(0, sizeof(uint32));
+	const auto bytes2 = bytes.subspan(sizeof(uint32), sizeof(uint64));
+	const auto part1 = *reinterpret_cast<const uint32*>(bytes1.data());
+	const auto part2 = *reinterpret_cast<const uint64*>(bytes2.data());
+	return Storage::Cache::Key{
+		Data::kTranslationCacheKeyTag | part1,
+		part2
+	};
+}
+
+Storage::Cache::Key CacheQuotasIndexKey() {
+	return Storage::Cache::Key{ Data::kCacheQuotasIndexKeyTag, 0 };
+}
+
 } // namespace Data
 
 void MessageCursor::fillFrom(not_null<const Ui::InputField*> field) {
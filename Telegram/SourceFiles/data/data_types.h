@@ -51,12 +51,16 @@ Storage::Cache::Key UrlCacheKey(const QString &location);
 Storage::Cache::Key GeoPointCacheKey(const GeoPointLocation &location);
 Storage::Cache::Key AudioAlbumThumbCacheKey(
 	const AudioAlbumThumbLocation &location);
+Storage::Cache::Key TranslationCacheKey(const QString &description);
+Storage::Cache::Key CacheQuotasIndexKey();
 
 constexpr auto kImageCacheTag = uint8(0x01);
 constexpr auto kStickerCacheTag = uint8(0x02);
 constexpr auto kVoiceMessageCacheTag = uint8(0x03);
 constexpr auto kVideoMessageCacheTag = uint8(0x04);
 constexpr auto kAnimationCacheTag = uint8(0x05);
+constexpr auto kWebmFramesCacheTag = uint8(0x06);
+constexpr auto kTranslationCacheTag = uint8(0x07);
 
 struct FileOrigin;
 
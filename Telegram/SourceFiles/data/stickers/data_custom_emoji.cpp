@@ -27,6 +27,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/text/text_custom_emoji.h"
 #include "ui/text/text_utilities.h"
 #include "ui/ui_utility.h"
+#include "storage/storage_cache_lookups.h"
 #include "apiwrap.h"
 #include "styles/style_chat.h"
 #include "styles/style_chat_helpers.h"
@@ -280,8 +281,10 @@ void CustomEmojiLoader::startCacheLookup(
 	});
 	const auto size = FrameSizeFromTag(_tag, _sizeOverride);
 	const auto weak = base::make_weak(&lookup->process->guard);
+	const auto lookups = document->owner().cacheLookups();
 	document->owner().cacheBigFile().get(key, [=](QByteArray value) {
 		auto cache = Ui::CustomEmoji::Cache::FromSerialized(value, size);
+		lookups->registerBigFileLookup(cache.has_value());
 		crl::on_main(weak, [=, result = std::move(cache)]() mutable {
 			lookupDone(lookup, std::move(result));
 		});
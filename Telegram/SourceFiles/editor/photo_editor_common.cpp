@@ -18,20 +18,29 @@ QImage ImageModified(QImage image, const PhotoModifications &mods) {
 	if (!mods) {
 		return image;
 	}
+	const auto full = image.rect();
+	const auto crop = mods.crop.isValid() ? mods.crop : full;
+	auto cropped = (crop != full) ? image.copy(crop) : std::move(image);
 	if (mods.paint) {
-		if (image.format() != QImage::Format_ARGB32_Premultiplied) {
-			image = image.convertToFormat(
+		if (cropped.format() != QImage::Format_ARGB32_Premultiplied) {
+			cropped = cropped.convertToFormat(
 				QImage::Format_ARGB32_Premultiplied);
 		}
 
-		Painter p(&image);
+		Painter p(&cropped);
 		PainterHighQualityEnabler hq(p);
 
-		mods.paint->render(&p, image.rect());
+		// The scene rect matches the original image, so render only
+		// the part of it that is left after cropping.
+		const auto source = crop.intersected(full);
+		mods.paint->render(
+			&p,
+			QRectF(source.translated(-crop.topLeft())),
+			QRectF(source));
+	}
+	if (!mods.flipped && !mods.angle) {
+		return cropped;
 	}
-	auto cropped = mods.crop.isValid()
-		? image.copy(mods.crop)
-		: image;
 	QTransform transform;
 	if (mods.flipped) {
 		transform.scale(-1, 1);
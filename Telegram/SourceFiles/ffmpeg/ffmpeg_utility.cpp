@@ -17,9 +17,23 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include <QImage>
 
+#include <thread>
+
 #ifdef LIB_FFMPEG_USE_QT_PRIVATE_API
 #include <private/qdrawhelper_p.h>
-#endif // LIB_FFMPEG_USE_QT_PRIVATE_API
+#elif defined __SSE2__ || defined _M_X64 // LIB_FFMPEG_USE_QT_PRIVATE_API
+#define LIB_FFMPEG_PREMULTIPLY_SSE2
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define LIB_FFMPEG_TARGET_AVX2
+#else // _MSC_VER
+#define LIB_FFMPEG_TARGET_AVX2 __attribute__((target("avx2")))
+#endif // _MSC_VER
+#elif defined __ARM_NEON // LIB_FFMPEG_USE_QT_PRIVATE_API || __SSE2__
+#define LIB_FFMPEG_PREMULTIPLY_NEON
+#include <arm_neon.h>
+#endif // LIB_FFMPEG_USE_QT_PRIVATE_API || __SSE2__ || __ARM_NEON
 
 extern "C" {
 #include <libavutil/opt.h>
@@ -35,6 +49,8 @@ constexpr auto kMaxScaleByAspectRatio = 16;
 constexpr auto kAvioBlockSize = 4096;
 constexpr auto kTimeUnknown = std::numeric_limits<crl::time>::min();
 constexpr auto kDurationMax = crl::time(std::numeric_limits<int>::max());
+constexpr auto kSwscaleThreadsMinArea = 1920 * 1080;
+constexpr auto kSwscaleThreadsMax = 4;
 
 using GetFormatMethod = enum AVPixelFormat(*)(
 	struct AVCodecContext *s,
@@ -57,17 +73,175 @@ void AlignedImageBufferCleanupHandler(void* data) {
 		&& (aspect.den <= aspect.num * kMaxScaleByAspectRatio);
 }
 
+[[nodiscard]] int SwscaleThreadsCount(QSize srcSize, QSize dstSize) {
+#if LIBSWSCALE_VERSION_INT >= AV_VERSION_INT(6, 1, 100)
+	const auto area = std::max(
+		srcSize.width() * srcSize.height(),
+		dstSize.width() * dstSize.height());
+	if (area < kSwscaleThreadsMinArea) {
+		return 1;
+	}
+	return std::clamp(
+		int(std::thread::hardware_concurrency()) / 2,
+		1,
+		kSwscaleThreadsMax);
+#else // LIBSWSCALE_VERSION_INT >= 6.1.100
+	return 1;
+#endif // LIBSWSCALE_VERSION_INT >= 6.1.100
+}
+
+[[nodiscard]] SwsContext *MakeThreadedSwscaleContext(
+		QSize srcSize,
+		int srcFormat,
+		QSize dstSize,
+		int dstFormat,
+		int threads) {
+	// Since libswscale 6.1 a context can convert horizontal slices of
+	// a single frame in parallel on its own thread pool.
+	auto result = sws_alloc_context();
+	if (!result) {
+		return nullptr;
+	}
+	const auto set = [&](const char *name, int64_t value) {
+		return av_opt_set_int(result, name, value, 0) >= 0;
+	};
+	if (!set("srcw", srcSize.width())
+		|| !set("srch", srcSize.height())
+		|| !set("src_format", srcFormat)
+		|| !set("dstw", dstSize.width())
+		|| !set("dsth", dstSize.height())
+		|| !set("dst_format", dstFormat)
+		|| !set("threads", threads)
+		|| sws_init_context(result, nullptr, nullptr) < 0) {
+		sws_freeContext(result);
+		return nullptr;
+	}
+	return result;
+}
+
 [[nodiscard]] bool IsAlignedImage(const QImage &image) {
 	return !(reinterpret_cast<uintptr_t>(image.bits()) % kAlignImageBy)
 		&& !(image.bytesPerLine() % kAlignImageBy);
 }
 
+#ifdef LIB_FFMPEG_PREMULTIPLY_SSE2
+
+// SSE2 is the x86_64 baseline, AVX2 is used if the CPU supports it.
+// SSE4.1 has nothing that makes these kernels shorter.
+[[nodiscard]] bool DetectAvx2() {
+#ifdef _MSC_VER
+	int info[4] = { 0 };
+	__cpuid(info, 0);
+	if (info[0] < 7) {
+		return false;
+	}
+	__cpuid(info, 1);
+	const auto osxsave = (info[2] & (1 << 27)) != 0;
+	const auto avx = (info[2] & (1 << 28)) != 0;
+	if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+		return false;
+	}
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else // _MSC_VER
+	return __builtin_cpu_supports("avx2");
+#endif // _MSC_VER
+}
+
+[[nodiscard]] bool HasAvx2() {
+	static const auto result = DetectAvx2();
+	return result;
+}
+
+// Returns the count of pixels processed, the rest is left for SSE2.
+LIB_FFMPEG_TARGET_AVX2 int UnPremultiplyAvx2(
+		uint *udst,
+		const uint *usrc,
+		int intsCount) {
+	const auto alphaMask = _mm256_set1_epi32(int(0xFF000000U));
+	auto i = 0;
+	for (; i + 8 <= intsCount; i += 8) {
+		const auto pixels = _mm256_loadu_si256(
+			reinterpret_cast<const __m256i*>(usrc + i));
+		const auto alpha = _mm256_and_si256(pixels, alphaMask);
+		const auto opaque = _mm256_cmpeq_epi32(alpha, alphaMask);
+		if (_mm256_movemask_epi8(opaque) == -1) {
+			_mm256_storeu_si256(
+				reinterpret_cast<__m256i*>(udst + i),
+				pixels);
+		} else {
+			for (auto j = i; j != i + 8; ++j) {
+				udst[j] = qUnpremultiply(usrc[j]);
+			}
+		}
+	}
+	return i;
+}
+
+LIB_FFMPEG_TARGET_AVX2 __m256i PremultiplyChannelsAvx2(__m256i channels) {
+	const auto half = _mm256_set1_epi16(0x80);
+	auto alpha = _mm256_shufflelo_epi16(channels, _MM_SHUFFLE(3, 3, 3, 3));
+	alpha = _mm256_shufflehi_epi16(alpha, _MM_SHUFFLE(3, 3, 3, 3));
+	const auto product = _mm256_mullo_epi16(channels, alpha);
+	return _mm256_srli_epi16(
+		_mm256_add_epi16(
+			_mm256_add_epi16(product, _mm256_srli_epi16(product, 8)),
+			half),
+		8);
+}
+
+// Same as the SSE2 loop, unpack and pack work inside 128 bit lanes,
+// so the pixel order is kept.
+LIB_FFMPEG_TARGET_AVX2 int PremultiplyAvx2(
+		uint *udst,
+		const uint *usrc,
+		int intsCount) {
+	const auto alphaMask = _mm256_set1_epi32(int(0xFF000000U));
+	const auto zero = _mm256_setzero_si256();
+	auto i = 0;
+	for (; i + 8 <= intsCount; i += 8) {
+		const auto pixels = _mm256_loadu_si256(
+			reinterpret_cast<const __m256i*>(usrc + i));
+		const auto colors = _mm256_packus_epi16(
+			PremultiplyChannelsAvx2(_mm256_unpacklo_epi8(pixels, zero)),
+			PremultiplyChannelsAvx2(_mm256_unpackhi_epi8(pixels, zero)));
+		_mm256_storeu_si256(
+			reinterpret_cast<__m256i*>(udst + i),
+			_mm256_or_si256(
+				_mm256_andnot_si256(alphaMask, colors),
+				_mm256_and_si256(alphaMask, pixels)));
+	}
+	return i;
+}
+
+#endif // LIB_FFMPEG_PREMULTIPLY_SSE2
+
 void UnPremultiplyLine(uchar *dst, const uchar *src, int intsCount) {
 	[[maybe_unused]] const auto udst = reinterpret_cast<uint*>(dst);
 	const auto usrc = reinterpret_cast<const uint*>(src);
 
 #ifndef LIB_FFMPEG_USE_QT_PRIVATE_API
-	for (auto i = 0; i != intsCount; ++i) {
+	auto i = 0;
+#ifdef LIB_FFMPEG_PREMULTIPLY_SSE2
+	if (HasAvx2()) {
+		i = UnPremultiplyAvx2(udst, usrc, intsCount);
+	}
+	// Blocks of opaque pixels are copied as is, like qUnpremultiply() does.
+	const auto alphaMask = _mm_set1_epi32(int(0xFF000000U));
+	for (; i + 4 <= intsCount; i += 4) {
+		const auto pixels = _mm_loadu_si128(
+			reinterpret_cast<const __m128i*>(usrc + i));
+		const auto alpha = _mm_and_si128(pixels, alphaMask);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, alphaMask)) == 0xFFFF) {
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(udst + i), pixels);
+		} else {
+			for (auto j = i; j != i + 4; ++j) {
+				udst[j] = qUnpremultiply(usrc[j]);
+			}
+		}
+	}
+#endif // LIB_FFMPEG_PREMULTIPLY_SSE2
+	for (; i != intsCount; ++i) {
 		udst[i] = qUnpremultiply(usrc[i]);
 	}
 #else // !LIB_FFMPEG_USE_QT_PRIVATE_API
@@ -81,7 +255,57 @@ void PremultiplyLine(uchar *dst, const uchar *src, int intsCount) {
 	[[maybe_unused]] const auto usrc = reinterpret_cast<const uint*>(src);
 
 #ifndef LIB_FFMPEG_USE_QT_PRIVATE_API
-	for (auto i = 0; i != intsCount; ++i) {
+	// Each color channel is computed with the qPremultiply() rounding:
+	// (c * a + ((c * a) >> 8) + 0x80) >> 8, that fits in 16 bits.
+	auto i = 0;
+#if defined LIB_FFMPEG_PREMULTIPLY_SSE2
+	if (HasAvx2()) {
+		i = PremultiplyAvx2(udst, usrc, intsCount);
+	}
+	const auto alphaMask = _mm_set1_epi32(int(0xFF000000U));
+	const auto half = _mm_set1_epi16(0x80);
+	const auto zero = _mm_setzero_si128();
+	const auto multiply = [&](__m128i channels) {
+		auto alpha = _mm_shufflelo_epi16(channels, _MM_SHUFFLE(3, 3, 3, 3));
+		alpha = _mm_shufflehi_epi16(alpha, _MM_SHUFFLE(3, 3, 3, 3));
+		const auto product = _mm_mullo_epi16(channels, alpha);
+		return _mm_srli_epi16(
+			_mm_add_epi16(
+				_mm_add_epi16(product, _mm_srli_epi16(product, 8)),
+				half),
+			8);
+	};
+	for (; i + 4 <= intsCount; i += 4) {
+		const auto pixels = _mm_loadu_si128(
+			reinterpret_cast<const __m128i*>(usrc + i));
+		const auto colors = _mm_packus_epi16(
+			multiply(_mm_unpacklo_epi8(pixels, zero)),
+			multiply(_mm_unpackhi_epi8(pixels, zero)));
+		_mm_storeu_si128(
+			reinterpret_cast<__m128i*>(udst + i),
+			_mm_or_si128(
+				_mm_andnot_si128(alphaMask, colors),
+				_mm_and_si128(alphaMask, pixels)));
+	}
+#elif defined LIB_FFMPEG_PREMULTIPLY_NEON
+	const auto multiply = [](uint8x8_t channel, uint8x8_t alpha) {
+		const auto product = vmull_u8(channel, alpha);
+		return vshrn_n_u16(
+			vaddq_u16(
+				vaddq_u16(product, vshrq_n_u16(product, 8)),
+				vdupq_n_u16(0x80)),
+			8);
+	};
+	for (; i + 8 <= intsCount; i += 8) {
+		auto pixels = vld4_u8(reinterpret_cast<const uint8_t*>(usrc + i));
+		const auto alpha = pixels.val[3];
+		pixels.val[0] = multiply(pixels.val[0], alpha);
+		pixels.val[1] = multiply(pixels.val[1], alpha);
+		pixels.val[2] = multiply(pixels.val[2], alpha);
+		vst4_u8(reinterpret_cast<uint8_t*>(udst + i), pixels);
+	}
+#endif // LIB_FFMPEG_PREMULTIPLY_SSE2 || LIB_FFMPEG_PREMULTIPLY_NEON
+	for (; i != intsCount; ++i) {
 		udst[i] = qPremultiply(usrc[i]);
 	}
 #else // !LIB_FFMPEG_USE_QT_PRIVATE_API
@@ -386,7 +610,8 @@ SwscalePointer MakeSwscalePointer(
 		int srcFormat,
 		QSize dstSize,
 		int dstFormat,
-		SwscalePointer *existing) {
+		SwscalePointer *existing,
+		bool threaded) {
 	// We have to use custom caching for SwsContext, because
 	// sws_getCachedContext checks passed flags with existing context flags,
 	// and re-creates context if they're different, but in the process of
@@ -406,36 +631,104 @@ SwscalePointer MakeSwscalePointer(
 		return SwscalePointer();
 	}
 
-	const auto result = sws_getCachedContext(
-		existing ? existing->release() : nullptr,
-		srcSize.width(),
-		srcSize.height(),
-		AVPixelFormat(srcFormat),
-		dstSize.width(),
-		dstSize.height(),
-		AVPixelFormat(dstFormat),
-		0,
-		nullptr,
-		nullptr,
-		nullptr);
+	const auto threads = threaded
+		? SwscaleThreadsCount(srcSize, dstSize)
+		: 1;
+	auto result = (threads > 1)
+		? MakeThreadedSwscaleContext(
+			srcSize,
+			srcFormat,
+			dstSize,
+			dstFormat,
+			threads)
+		: nullptr;
+	const auto withThreads = (result != nullptr);
+	if (!result) {
+		result = sws_getCachedContext(
+			existing ? existing->release() : nullptr,
+			srcSize.width(),
+			srcSize.height(),
+			AVPixelFormat(srcFormat),
+			dstSize.width(),
+			dstSize.height(),
+			AVPixelFormat(dstFormat),
+			0,
+			nullptr,
+			nullptr,
+			nullptr);
+	}
 	if (!result) {
 		LogError(u"sws_getCachedContext"_q);
 	}
 	return SwscalePointer(
 		result,
-		{ srcSize, srcFormat, dstSize, dstFormat });
+		{ srcSize, srcFormat, dstSize, dstFormat, withThreads ? threads : 1 });
 }
 
 SwscalePointer MakeSwscalePointer(
 		not_null<AVFrame*> frame,
 		QSize resize,
-		SwscalePointer *existing) {
+		SwscalePointer *existing,
+		bool threaded) {
 	return MakeSwscalePointer(
 		QSize(frame->width, frame->height),
 		frame->format,
 		resize,
 		AV_PIX_FMT_BGRA,
-		existing);
+		existing,
+		threaded);
+}
+
+bool SwscaleToImage(
+		const SwscalePointer &swscale,
+		not_null<AVFrame*> frame,
+		QImage &storage) {
+	Expects(swscale != nullptr);
+
+#if LIBSWSCALE_VERSION_INT >= AV_VERSION_INT(6, 1, 100)
+	if (swscale.get_deleter().threads > 1) {
+		// Slice threads are used only by the frame based API.
+		auto to = MakeFramePointer();
+		if (!to) {
+			return false;
+		}
+		to->buf[0] = av_buffer_create(
+			storage.bits(),
+			storage.sizeInBytes(),
+			[](void *opaque, uint8_t *data) {},
+			nullptr,
+			0);
+		if (!to->buf[0]) {
+			return false;
+		}
+		to->data[0] = storage.bits();
+		to->linesize[0] = storage.bytesPerLine();
+		to->width = storage.width();
+		to->height = storage.height();
+		to->format = AV_PIX_FMT_BGRA;
+		const auto error = AvErrorWrap(
+			sws_scale_frame(swscale.get(), to.get(), frame));
+		if (error) {
+			LogError(u"sws_scale_frame"_q, error);
+			return false;
+		}
+		return true;
+	}
+#endif // LIBSWSCALE_VERSION_INT >= 6.1.100
+
+	// AV_NUM_DATA_POINTERS defined in AVFrame struct
+	uint8_t *data[AV_NUM_DATA_POINTERS] = { storage.bits(), nullptr };
+	int linesize[AV_NUM_DATA_POINTERS] = { int(storage.bytesPerLine()), 0 };
+
+	sws_scale(
+		swscale.get(),
+		frame->data,
+		frame->linesize,
+		0,
+		frame->height,
+		data,
+		linesize);
+	return true;
 }
 
 void SwscaleDeleter::operator()(SwsContext *value) {
@@ -150,6 +150,7 @@ struct SwscaleDeleter {
 	int srcFormat = int(AV_PIX_FMT_NONE);
 	QSize dstSize;
 	int dstFormat = int(AV_PIX_FMT_NONE);
+	int threads = 1;
 
 	void operator()(SwsContext *value);
 };
@@ -159,11 +160,20 @@ using SwscalePointer = std::unique_ptr<SwsContext, SwscaleDeleter>;
 	int srcFormat,
 	QSize dstSize,
 	int dstFormat, // This field doesn't take part in caching!
-	SwscalePointer *existing = nullptr);
+	SwscalePointer *existing = nullptr,
+	bool threaded = false);
 [[nodiscard]] SwscalePointer MakeSwscalePointer(
 	not_null<AVFrame*> frame,
 	QSize resize,
-	SwscalePointer *existing = nullptr);
+	SwscalePointer *existing = nullptr,
+	bool threaded = false);
+
+// Converts in parallel slices if the context was created with threads.
+// Threads are worth it only for a context reused across many frames.
+[[nodiscard]] bool SwscaleToImage(
+	const SwscalePointer &swscale,
+	not_null<AVFrame*> frame,
+	QImage &storage);
 
 void LogError(const QString &method);
 void LogError(const QString &method, FFmpeg::AvErrorWrap error);
@@ -481,54 +481,15 @@ void History::destroyMessage(not_null<HistoryItem*> item) {
 	Expects(item->isHistoryEntry() || !item->mainView());
 
 	// AyuGram saveDeletedMessages
-	const auto settings = &AyuSettings::getInstance();
-	if (settings->saveDeletedMessages && item->isRegular() && !item->isGroupMigrate())
+	if (keepsDeletedMessage(item))
 	{
 		if (!item->isService())
 		{
-			item->setAyuHint(settings->deletedMark);
+			item->setAyuHint(AyuSettings::getInstance().deletedMark);
 		}
 		else
 		{
-			const auto msg = TextWithEntities{
-				"Message deleted",
-				{
-					EntityInText(
-						EntityType::Italic,
-						0,
-						15,
-						"Message deleted"
-					)
-				}
-			};
-
-			auto flags = MessageFlag::HasFromId
-				| MessageFlag::HasReplyInfo
-				| MessageFlag::HasPostAuthor;
-
-			if (item->isPost())
-			{
-				flags |= MessageFlag::Post;
-			}
-
-			FullReplyTo replyTo = {
-				.messageId = item->fullId(),
-				.storyId = {},
-				.topicRootId = item->topicRootId(),
-			};
-
-			addNewLocalMessage(
-				session().data().nextLocalMessageId(),
-				flags,
-				UserId(),
-                replyTo,
-				base::unixtime::now(),
-				item->author()->id,
-				"AyuGram"_q,
-				msg,
-				MTP_messageMediaEmpty(),
-				HistoryMessageMarkupData(),
-				uint64(0));
+			addDeletedMessageNotice(item);
 		}
 
 		return;
@@ -574,6 +535,86 @@ void History::destroyMessage(not_null<HistoryItem*> item) {
 	}
 }
 
+bool History::keepsDeletedMessage(not_null<HistoryItem*> item) const {
+	return AyuSettings::getInstance().saveDeletedMessages
+		&& item->isRegular()
+		&& !item->isGroupMigrate();
+}
+
+void History::markMessagesDeleted(
+		const std::vector<not_null<HistoryItem*>> &items) {
+	const auto &hint = AyuSettings::getInstance().deletedMark;
+	for (const auto &item : items) {
+		Assert(item->history() == this);
+
+		if (item->isService()) {
+			addDeletedMessageNotice(item);
+		} else if (item->updateAyuHint(hint)) {
+			// The refreshed views wait for a resize, so the whole batch
+			// is laid out once, when the history change is sent.
+			owner().requestItemViewRefresh(item);
+		}
+	}
+}
+
+void History::destroyOrMarkDeleted(
+		const std::vector<not_null<HistoryItem*>> &items) {
+	auto kept = std::vector<not_null<HistoryItem*>>();
+	for (const auto &item : items) {
+		if (keepsDeletedMessage(item)) {
+			kept.push_back(item);
+		} else {
+			item->destroy();
+		}
+	}
+	if (!kept.empty()) {
+		markMessagesDeleted(kept);
+		owner().sendHistoryChangeNotifications();
+	}
+}
+
+void History::addDeletedMessageNotice(not_null<HistoryItem*> item) {
+	const auto msg = TextWithEntities{
+		"Message deleted",
+		{
+			EntityInText(
+				EntityType::Italic,
+				0,
+				15,
+				"Message deleted"
+			)
+		}
+	};
+
+	auto flags = MessageFlag::HasFromId
+		| MessageFlag::HasReplyInfo
+		| MessageFlag::HasPostAuthor;
+
+	if (item->isPost())
+	{
+		flags |= MessageFlag::Post;
+	}
+
+	FullReplyTo replyTo = {
+		.messageId = item->fullId(),
+		.storyId = {},
+		.topicRootId = item->topicRootId(),
+	};
+
+	addNewLocalMessage(
+		session().data().nextLocalMessageId(),
+		flags,
+		UserId(),
+		replyTo,
+		base::unixtime::now(),
+		item->author()->id,
+		"AyuGram"_q,
+		msg,
+		MTP_messageMediaEmpty(),
+		HistoryMessageMarkupData(),
+		uint64(0));
+}
+
 void History::destroyMessagesByDates(TimeId minDate, TimeId maxDate) {
 	auto toDestroy = std::vector<not_null<HistoryItem*>>();
 	toDestroy.reserve(_messages.size());
@@ -584,9 +625,7 @@ void History::destroyMessagesByDates(TimeId minDate, TimeId maxDate) {
 			toDestroy.push_back(message.get());
 		}
 	}
-	for (const auto item : toDestroy) {
-		item->destroy();
-	}
+	destroyOrMarkDeleted(toDestroy);
 }
 
 void History::destroyMessagesByTopic(MsgId topicRootId) {
@@ -597,9 +636,7 @@ void History::destroyMessagesByTopic(MsgId topicRootId) {
 			toDestroy.push_back(message.get());
 		}
 	}
-	for (const auto item : toDestroy) {
-		item->destroy();
-	}
+	destroyOrMarkDeleted(toDestroy);
 }
 
 void History::unpinMessagesFor(MsgId topicRootId) {
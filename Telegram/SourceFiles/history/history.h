@@ -137,6 +137,12 @@ public:
 	void destroyMessagesByDates(TimeId minDate, TimeId maxDate);
 	void destroyMessagesByTopic(MsgId topicRootId);
 
+	// AyuGram saveDeletedMessages
+	[[nodiscard]] bool keepsDeletedMessage(
+		not_null<HistoryItem*> item) const;
+	void markMessagesDeleted(
+		const std::vector<not_null<HistoryItem*>> &items);
+
 	void unpinMessagesFor(MsgId topicRootId);
 
 	not_null<HistoryItem*> addNewMessage(
@@ -576,6 +582,10 @@ private:
 
 	void viewReplaced(not_null<const Element*> was, Element *now);
 
+	void addDeletedMessageNotice(not_null<HistoryItem*> item);
+	void destroyOrMarkDeleted(
+		const std::vector<not_null<HistoryItem*>> &items);
+
 	void createLocalDraftFromCloud(MsgId topicRootId);
 
 	HistoryItem *insertJoinedMessage();
@@ -2577,7 +2577,15 @@ void HistoryItem::setPostAuthor(const QString &postAuthor) {
 }
 
 void HistoryItem::setAyuHint(const QString &hint) {
-	const auto settings = &AyuSettings::getInstance();
+	if (!updateAyuHint(hint)) {
+		return;
+	} else if (!hint.isEmpty()) {
+		history()->owner().requestItemViewRefresh(this);
+	}
+	history()->owner().requestItemResize(this);
+}
+
+bool HistoryItem::updateAyuHint(const QString &hint) {
 	if (!(_flags & MessageFlag::HasPostAuthor))
 	{
 		_flags |= MessageFlag::HasPostAuthor;
@@ -2586,24 +2594,21 @@ void HistoryItem::setAyuHint(const QString &hint) {
 	auto msgsigned = Get<HistoryMessageSigned>();
 	if (hint.isEmpty()) {
 		if (!msgsigned) {
-			return;
+			return false;
 		}
 		RemoveComponents(HistoryMessageSigned::Bit());
-		history()->owner().requestItemResize(this);
-		return;
+		return true;
 	}
 	if (!msgsigned) {
 		AddComponents(HistoryMessageSigned::Bit());
 		msgsigned = Get<HistoryMessageSigned>();
 	} else if (msgsigned->postAuthor == hint) {
-		return;
+		return false;
 	}
 	msgsigned->postAuthor = hint;
 	msgsigned->isAnonymousRank = !isDiscussionPost()
 		&& this->author()->isMegagroup();
-
-	history()->owner().requestItemViewRefresh(this);
-	history()->owner().requestItemResize(this);
+	return true;
 }
 
 void HistoryItem::setReplies(HistoryMessageRepliesData &&data) {
@@ -401,6 +401,8 @@ public:
 		bool isForumPost);
 	void setPostAuthor(const QString &author);
 	void setAyuHint(const QString &hint);
+	// Doesn't request any view updates, returns true if the hint changed.
+	[[nodiscard]] bool updateAyuHint(const QString &hint);
 	void setRealId(MsgId newId);
 	void incrementReplyToTopCounter();
 
@@ -22,6 +22,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "boxes/premium_limits_box.h"
 #include "boxes/peers/edit_peer_permissions_box.h" // ShowAboutGigagroup.
 #include "boxes/peers/edit_peer_requests_box.h"
+#include "core/core_tracing.h"
 #include "core/file_utilities.h"
 #include "core/mime_type.h"
 #include "ui/emoji_config.h"
@@ -4343,10 +4344,7 @@ void HistoryWidget::chooseAttach(
 			}
 		} else {
 			const auto premium = controller()->session().user()->isPremium();
-			auto list = Storage::PrepareMediaList(
-				result.paths,
-				st::sendMediaPreviewSize,
-				premium);
+			auto list = Storage::CollectMediaList(result.paths, premium);
 			list.overrideSendImagesAsPhotos = overrideSendImagesAsPhotos;
 			confirmSendingFiles(std::move(list));
 		}
@@ -5308,7 +5306,7 @@ bool HistoryWidget::confirmSendingFiles(
 		const QString &insertTextOnCancel) {
 	const auto premium = controller()->session().user()->isPremium();
 	return confirmSendingFiles(
-		Storage::PrepareMediaList(files, st::sendMediaPreviewSize, premium),
+		Storage::CollectMediaList(files, premium),
 		insertTextOnCancel);
 }
 
@@ -5457,10 +5455,7 @@ bool HistoryWidget::confirmSendingFiles(
 	const auto premium = controller()->session().user()->isPremium();
 
 	if (const auto urls = Core::ReadMimeUrls(data); !urls.empty()) {
-		auto list = Storage::PrepareMediaList(
-			urls,
-			st::sendMediaPreviewSize,
-			premium);
+		auto list = Storage::CollectMediaList(urls, premium);
 		if (list.error != Ui::PreparedList::Error::NonLocalUrl) {
 			if (list.error == Ui::PreparedList::Error::None
 				|| !hasImage) {
@@ -8058,6 +8053,7 @@ bool HistoryWidget::paintShowAnimationFrame() {
 }
 
 void HistoryWidget::paintEvent(QPaintEvent *e) {
+	const auto zone = Core::Tracing::Zone("HistoryWidget::paintEvent");
 	if (paintShowAnimationFrame()
 		|| controller()->contentOverlapped(this, e)) {
 		return;
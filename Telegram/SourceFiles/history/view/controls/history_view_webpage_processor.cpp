@@ -7,6 +7,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "history/view/controls/history_view_webpage_processor.h"
 
+#include "api/api_web_page_previews.h"
+#include "apiwrap.h"
 #include "base/unixtime.h"
 #include "data/data_chat_participant_status.h"
 #include "data/data_file_origin.h"
@@ -15,8 +17,14 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/history.h"
 #include "lang/lang_keys.h"
 #include "main/main_session.h"
+#include "ui/widgets/fields/input_field.h"
 
 namespace HistoryView::Controls {
+namespace {
+
+constexpr auto kIncompleteLinkDelay = crl::time(500);
+
+} // namespace
 
 WebPageText TitleAndDescriptionFromWebPage(not_null<WebPageData*> d) {
 	QString resultTitle, resultDescription;
@@ -111,73 +119,43 @@ WebPageText ProcessWebPageData(WebPageData *page) {
 }
 
 WebpageResolver::WebpageResolver(not_null<Main::Session*> session)
-: _session(session)
-, _api(&session->mtp()) {
+: _previews(&session->api().webPagePreviews()) {
+	_previews->resolved(
+	) | rpl::filter([=](const QString &link) {
+		return !_previews->pending(link);
+	}) | rpl::start_with_next([=](const QString &link) {
+		_requested.remove(link);
+	}, _lifetime);
+}
+
+WebpageResolver::~WebpageResolver() {
+	for (const auto &link : base::take(_requested)) {
+		_previews->cancel(link);
+	}
 }
 
 std::optional<WebPageData*> WebpageResolver::lookup(
 		const QString &link) const {
-	const auto i = _cache.find(link);
-	return (i == end(_cache))
-		? std::optional<WebPageData*>()
-		: (i->second && !i->second->failed)
-		? i->second
-		: nullptr;
+	return _previews->lookup(link);
+}
+
+rpl::producer<QString> WebpageResolver::resolved() const {
+	return _previews->resolved();
 }
 
 QString WebpageResolver::find(not_null<WebPageData*> page) const {
-	for (const auto &[link, cached] : _cache) {
-		if (cached == page) {
-			return link;
-		}
-	}
-	return QString();
+	return _previews->find(page);
 }
 
 void WebpageResolver::request(const QString &link, bool force) {
-	if (_requestLink == link && !force) {
-		return;
+	if (!_requested.contains(link) && _previews->request(link, force)) {
+		_requested.emplace(link);
 	}
-	const auto done = [=](const MTPDmessageMediaWebPage &data) {
-		const auto page = _session->data().processWebpage(data.vwebpage());
-		if (page->pendingTill > 0
-			&& page->pendingTill < base::unixtime::now()) {
-			page->pendingTill = 0;
-			page->failed = true;
-		}
-		_cache.emplace(link, page->failed ? nullptr : page.get());
-		_resolved.fire_copy(link);
-	};
-	const auto fail = [=] {
-		_cache.emplace(link, nullptr);
-		_resolved.fire_copy(link);
-	};
-	_requestLink = link;
-	_requestId = _api.request(
-		MTPmessages_GetWebPagePreview(
-			MTP_flags(0),
-			MTP_string(link),
-			MTPVector<MTPMessageEntity>()
-	)).done([=](const MTPMessageMedia &result, mtpRequestId requestId) {
-		if (_requestId == requestId) {
-			_requestId = 0;
-		}
-		result.match([=](const MTPDmessageMediaWebPage &data) {
-			done(data);
-		}, [&](const auto &d) {
-			fail();
-		});
-	}).fail([=](const MTP::Error &error, mtpRequestId requestId) {
-		if (_requestId == requestId) {
-			_requestId = 0;
-		}
-		fail();
-	}).send();
 }
 
 void WebpageResolver::cancel(const QString &link) {
-	if (_requestLink == link) {
-		_api.request(base::take(_requestId)).cancel();
+	if (_requested.remove(link)) {
+		_previews->cancel(link);
 	}
 }
 
@@ -185,6 +163,7 @@ WebpageProcessor::WebpageProcessor(
 	not_null<History*> history,
 	not_null<Ui::InputField*> field)
 : _history(history)
+, _field(field)
 , _resolver(std::make_shared<WebpageResolver>(&history->session()))
 , _parser(field)
 , _timer([=] {
@@ -192,6 +171,12 @@ WebpageProcessor::WebpageProcessor(
 		return;
 	}
 	_resolver->request(_link, true);
+})
+, _requestTimer([=] {
+	if (!_data && !_link.isEmpty()) {
+		++_requestsCount;
+		_resolver->request(_link);
+	}
 }) {
 	_history->session().downloaderTaskFinished(
 	) | rpl::filter([=] {
@@ -210,6 +195,13 @@ WebpageProcessor::WebpageProcessor(
 	_parser.list().changes(
 	) | rpl::start_with_next([=](QStringList &&parsed) {
 		_parsedLinks = std::move(parsed);
+		if (_parsedLinks.empty() && _lookupsCount) {
+			DEBUG_LOG(("Webpage Info: "
+				"%1 preview lookups and %2 requests for a message."
+				).arg(_lookupsCount
+				).arg(_requestsCount));
+			_lookupsCount = _requestsCount = 0;
+		}
 		checkPreview();
 	}, _lifetime);
 
@@ -278,6 +270,7 @@ void WebpageProcessor::apply(Data::WebPageDraft draft, bool reparse) {
 			}
 			updateFromData();
 		} else {
+			_requestTimer.cancel();
 			_resolver->request(_link);
 			return;
 		}
@@ -286,6 +279,7 @@ void WebpageProcessor::apply(Data::WebPageDraft draft, bool reparse) {
 		checkNow(reparse);
 	}
 	if (_link != was) {
+		_requestTimer.cancel();
 		_resolver->cancel(was);
 	}
 }
@@ -364,6 +358,7 @@ void WebpageProcessor::checkPreview() {
 	auto page = (WebPageData*)nullptr;
 	auto chosen = QString();
 	for (const auto &link : _links) {
+		++_lookupsCount;
 		const auto value = _resolver->lookup(link);
 		if (!value) {
 			chosen = link;
@@ -375,10 +370,10 @@ void WebpageProcessor::checkPreview() {
 		}
 	}
 	if (_link != chosen) {
-		_resolver->cancel(_link);
+		cancelLink();
 		_link = chosen;
 		if (!page && !_link.isEmpty()) {
-			_resolver->request(_link);
+			requestLink();
 		}
 	}
 	if (page) {
@@ -392,6 +387,33 @@ void WebpageProcessor::checkPreview() {
 	updateFromData();
 }
 
+void WebpageProcessor::requestLink() {
+	if (linkMayBeIncomplete()) {
+		_requestTimer.callOnce(kIncompleteLinkDelay);
+	} else {
+		_requestTimer.cancel();
+		++_requestsCount;
+		_resolver->request(_link);
+	}
+}
+
+void WebpageProcessor::cancelLink() {
+	_requestTimer.cancel();
+	_resolver->cancel(_link);
+}
+
+bool WebpageProcessor::linkMayBeIncomplete() const {
+	// A link right at the end of the text may be still being typed.
+	const auto &ranges = _parser.ranges();
+	if (ranges.empty() || !ranges.back().custom.isEmpty()) {
+		return false;
+	}
+	const auto &text = _field->getTextWithTags().text;
+	const auto &last = ranges.back();
+	return (last.start + last.length == text.size())
+		&& (text.mid(last.start, last.length) == _link);
+}
+
 rpl::producer<WebpageParsed> WebpageProcessor::parsedValue() const {
 	return _parsed.value();
 }
@@ -13,6 +13,10 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 class History;
 
+namespace Api {
+class WebPagePreviews;
+} // namespace Api
+
 namespace Main {
 class Session;
 } // namespace Main
@@ -50,29 +54,28 @@ struct WebpageParsed {
 	}
 };
 
+// Resolved links and pending requests are kept by Api::WebPagePreviews
+// of the session, each resolver only tracks the links it is waiting for.
 class WebpageResolver final {
 public:
 	explicit WebpageResolver(not_null<Main::Session*> session);
+	~WebpageResolver();
 
 	[[nodiscard]] std::optional<WebPageData*> lookup(
 			const QString &link) const;
-	[[nodiscard]] rpl::producer<QString> resolved() const {
-		return _resolved.events();
-	}
+	[[nodiscard]] rpl::producer<QString> resolved() const;
 
 	[[nodiscard]] QString find(not_null<WebPageData*> page) const;
 
+	// Without force a recently resolved link is reported from the cache.
 	void request(const QString &link, bool force = false);
 	void cancel(const QString &link);
 
 private:
-	const not_null<Main::Session*> _session;
-	MTP::Sender _api;
-	base::flat_map<QString, WebPageData*> _cache;
-	rpl::event_stream<QString> _resolved;
+	const not_null<Api::WebPagePreviews*> _previews;
+	base::flat_set<QString> _requested;
 
-	QString _requestLink;
-	mtpRequestId _requestId = 0;
+	rpl::lifetime _lifetime;
 
 };
 
@@ -106,8 +109,12 @@ public:
 private:
 	void updateFromData();
 	void checkPreview();
+	void requestLink();
+	void cancelLink();
+	[[nodiscard]] bool linkMayBeIncomplete() const;
 
 	const not_null<History*> _history;
+	const not_null<Ui::InputField*> _field;
 	const std::shared_ptr<WebpageResolver> _resolver;
 	MessageLinksParser _parser;
 
@@ -121,6 +128,9 @@ private:
 	rpl::variable<WebpageParsed> _parsed;
 
 	base::Timer _timer;
+	base::Timer _requestTimer;
+	int _lookupsCount = 0;
+	int _requestsCount = 0;
 
 	rpl::lifetime _lifetime;
 
@@ -632,6 +632,8 @@ auto Message::takeReactionAnimations()
 }
 
 QSize Message::performCountOptimalSize() {
+	_geometry.width = -1;
+
 	const auto item = data();
 	const auto markup = item->inlineReplyMarkup();
 	const auto reactionsKey = [&] {
@@ -3813,6 +3815,24 @@ QRect Message::innerGeometry() const {
 }
 
 QRect Message::countGeometry() const {
+	const auto top = marginTop();
+	const auto bottom = marginBottom();
+	if (_geometry.width != width()
+		|| _geometry.height != height()
+		|| _geometry.marginTop != top
+		|| _geometry.marginBottom != bottom) {
+		_geometry = {
+			.rect = computeGeometry(),
+			.width = width(),
+			.height = height(),
+			.marginTop = top,
+			.marginBottom = bottom,
+		};
+	}
+	return _geometry.rect;
+}
+
+QRect Message::computeGeometry() const {
 	const auto item = data();
 	const auto centeredView = item->isFakeBotAbout()
 		|| (context() == Context::Replies && item->isDiscussionPost());
@@ -3911,6 +3931,7 @@ Ui::BubbleRounding Message::countBubbleRounding() const {
 }
 
 int Message::resizeContentGetHeight(int newWidth) {
+	_geometry.width = -1;
 	if (isHidden()) {
 		return marginTop() + marginBottom();
 	} else if (newWidth < st::msgMinWidth) {
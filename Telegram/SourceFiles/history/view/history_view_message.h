@@ -259,6 +259,7 @@ private:
 
 	void updateMediaInBubbleState();
 	QRect countGeometry() const;
+	[[nodiscard]] QRect computeGeometry() const;
 	[[nodiscard]] Ui::BubbleRounding countMessageRounding() const;
 	[[nodiscard]] Ui::BubbleRounding countBubbleRounding(
 		Ui::BubbleRounding messageRounding) const;
@@ -314,6 +315,17 @@ private:
 	uint32 _bubbleWidthLimit : 31 = 0;
 	uint32 _invertMedia : 1 = 0;
 
+	// countGeometry() is used by paint and by every hit test, so it is
+	// cached until the next layout or a change of the element size.
+	struct GeometryCache {
+		QRect rect;
+		int width = -1;
+		int height = 0;
+		int marginTop = 0;
+		int marginBottom = 0;
+	};
+	mutable GeometryCache _geometry;
+
 	BottomInfo _bottomInfo;
 
 };
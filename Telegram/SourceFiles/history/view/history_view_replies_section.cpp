@@ -887,10 +887,7 @@ void RepliesWidget::chooseAttach(
 			}
 		} else {
 			const auto premium = controller()->session().user()->isPremium();
-			auto list = Storage::PrepareMediaList(
-				result.paths,
-				st::sendMediaPreviewSize,
-				premium);
+			auto list = Storage::CollectMediaList(result.paths, premium);
 			list.overrideSendImagesAsPhotos = overrideSendImagesAsPhotos;
 			confirmSendingFiles(std::move(list));
 		}
@@ -905,10 +902,7 @@ bool RepliesWidget::confirmSendingFiles(
 	const auto premium = controller()->session().user()->isPremium();
 
 	if (const auto urls = Core::ReadMimeUrls(data); !urls.empty()) {
-		auto list = Storage::PrepareMediaList(
-			urls,
-			st::sendMediaPreviewSize,
-			premium);
+		auto list = Storage::CollectMediaList(urls, premium);
 		if (list.error != Ui::PreparedList::Error::NonLocalUrl) {
 			if (list.error == Ui::PreparedList::Error::None
 				|| !hasImage) {
@@ -2056,7 +2050,7 @@ bool RepliesWidget::confirmSendingFiles(
 		const QString &insertTextOnCancel) {
 	const auto premium = controller()->session().user()->isPremium();
 	return confirmSendingFiles(
-		Storage::PrepareMediaList(files, st::sendMediaPreviewSize, premium),
+		Storage::CollectMediaList(files, premium),
 		insertTextOnCancel);
 }
 
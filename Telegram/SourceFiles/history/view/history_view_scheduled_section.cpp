@@ -343,10 +343,7 @@ void ScheduledWidget::chooseAttach() {
 			}
 		} else {
 			const auto premium = controller()->session().user()->isPremium();
-			auto list = Storage::PrepareMediaList(
-				result.paths,
-				st::sendMediaPreviewSize,
-				premium);
+			auto list = Storage::CollectMediaList(result.paths, premium);
 			confirmSendingFiles(std::move(list));
 		}
 	}), nullptr);
@@ -360,10 +357,7 @@ bool ScheduledWidget::confirmSendingFiles(
 	const auto premium = controller()->session().user()->isPremium();
 
 	if (const auto urls = Core::ReadMimeUrls(data); !urls.empty()) {
-		auto list = Storage::PrepareMediaList(
-			urls,
-			st::sendMediaPreviewSize,
-			premium);
+		auto list = Storage::CollectMediaList(urls, premium);
 		if (list.error != Ui::PreparedList::Error::NonLocalUrl) {
 			if (list.error == Ui::PreparedList::Error::None
 				|| !hasImage) {
@@ -14,6 +14,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_changes.h"
 #include "data/data_peer_values.h" // Data::AmPremiumValue.
 #include "data/data_session.h"
+#include "data/data_translations.h"
 #include "history/history.h"
 #include "history/history_item.h"
 #include "history/history_item_components.h"
@@ -21,6 +22,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "main/main_session.h"
 #include "spellcheck/platform/platform_language.h"
 
+#include <crl/crl_async.h>
+#include <crl/crl_on_main.h>
+
 namespace HistoryView {
 namespace {
 
@@ -29,6 +33,76 @@ constexpr auto kEnoughForTranslation = 6;
 constexpr auto kMaxCheckInBunch = 100;
 constexpr auto kRequestLengthLimit = 24 * 1024;
 constexpr auto kRequestCountLimit = 20;
+constexpr auto kRecognizedCacheLimit = 4096;
+
+// Recognized languages are shared by all trackers, so that reopening
+// a chat or showing the same messages in a thread doesn't run cld3 again.
+class RecognizedCache final {
+public:
+	[[nodiscard]] std::optional<LanguageId> find(
+		FullMsgId id,
+		const QString &text);
+	void add(FullMsgId id, const QString &text, LanguageId language);
+
+private:
+	struct Key {
+		FullMsgId id;
+		size_t textHash = 0;
+
+		friend inline auto operator<=>(const Key &, const Key &) = default;
+	};
+	struct Entry {
+		LanguageId language;
+		uint64 used = 0;
+	};
+
+	base::flat_map<Key, Entry> _entries;
+	uint64 _counter = 0;
+
+};
+
+std::optional<LanguageId> RecognizedCache::find(
+		FullMsgId id,
+		const QString &text) {
+	const auto i = _entries.find({ id, qHash(text) });
+	if (i == end(_entries)) {
+		return std::nullopt;
+	}
+	i->second.used = ++_counter;
+	return i->second.language;
+}
+
+void RecognizedCache::add(
+		FullMsgId id,
+		const QString &text,
+		LanguageId language) {
+	_entries[{ id, qHash(text) }] = { language, ++_counter };
+	if (_entries.size() <= kRecognizedCacheLimit) {
+		return;
+	}
+	// Drop the least recently used quarter at once.
+	auto used = ranges::views::all(
+		_entries
+	) | ranges::views::transform([](const auto &pair) {
+		return pair.second.used;
+	}) | ranges::to_vector;
+	const auto border = begin(used) + kRecognizedCacheLimit / 4;
+	ranges::nth_element(used, border);
+	const auto oldest = *border;
+	auto kept = base::flat_map<Key, Entry>();
+	kept.reserve(_entries.size() - kRecognizedCacheLimit / 4);
+	for (const auto &[key, entry] : _entries) {
+		if (entry.used >= oldest) {
+			kept.emplace(key, entry);
+		}
+	}
+	_entries = std::move(kept);
+}
+
+[[nodiscard]] RecognizedCache &Recognized() {
+	static auto result = RecognizedCache();
+	return result;
+}
 
 } // namespace
 
@@ -135,11 +209,10 @@ bool TranslateTracker::add(
 		return true;
 	}
 	const auto &text = item->originalText().text;
+	const auto cached = Recognized().find(id, text);
 	_itemsForRecognize.emplace(id, ItemForRecognize{
 		.generation = _generation,
-		.id = (_trackingLanguage.current()
-			? Platform::Language::Recognize(text)
-			: MaybeLanguageId{ text }),
+		.id = (cached ? MaybeLanguageId{ *cached } : MaybeLanguageId{ text }),
 	});
 	++_addedInBunch;
 	return true;
@@ -149,9 +222,41 @@ void TranslateTracker::switchTranslation(
 		not_null<HistoryItem*> item,
 		LanguageId id) {
 	if (item->translationShowRequiresRequest(id)) {
-		_itemsToRequest.emplace(
-			item->fullId(),
-			ItemToRequest{ int(item->originalText().text.size()) });
+		const auto itemId = item->fullId();
+		// A lookup for the previous language may still be running,
+		// its result is ignored when it arrives.
+		_itemsInCacheLookup[itemId] = ItemInCacheLookup{
+			.to = id,
+			.length = int(item->originalText().text.size()),
+		};
+		Data::LoadCachedTranslation(item, id, crl::guard(this, [=](
+				TextWithEntities &&text) {
+			cacheLookupDone(itemId, id, std::move(text));
+		}));
+	}
+}
+
+void TranslateTracker::cacheLookupDone(
+		FullMsgId id,
+		LanguageId to,
+		TextWithEntities &&text) {
+	const auto i = _itemsInCacheLookup.find(id);
+	if (i == end(_itemsInCacheLookup) || i->second.to != to) {
+		return;
+	}
+	const auto entry = ItemToRequest{ i->second.length };
+	_itemsInCacheLookup.erase(i);
+	const auto item = _history->owner().message(id);
+	if (!item) {
+		return;
+	} else if (!text.empty()) {
+		item->translationDone(to, std::move(text));
+		return;
+	}
+	const auto translation = item->translation();
+	if (translation && translation->to == to && translation->requested) {
+		_itemsToRequest.emplace(id, entry);
+		requestSome();
 	}
 }
 
@@ -161,6 +266,7 @@ void TranslateTracker::finishBunch() {
 		_addedInBunch = -1;
 		applyLimit();
 		if (_trackingLanguage.current()) {
+			recognizeCollected();
 			checkRecognized();
 		}
 	}
@@ -213,14 +319,16 @@ void TranslateTracker::addBunchFrom(
 }
 
 void TranslateTracker::cancelToRequest() {
-	if (!_itemsToRequest.empty()) {
-		const auto owner = &_history->owner();
-		for (const auto &[id, entry] : base::take(_itemsToRequest)) {
+	const auto owner = &_history->owner();
+	const auto cancel = [&](auto &list) {
+		for (const auto &[id, entry] : base::take(list)) {
 			if (const auto item = owner->message(id)) {
 				item->translationShowRequiresRequest({});
 			}
 		}
-	}
+	};
+	cancel(_itemsInCacheLookup);
+	cancel(_itemsToRequest);
 }
 
 void TranslateTracker::cancelSentRequest() {
@@ -296,6 +404,7 @@ void TranslateTracker::requestDone(
 				qs(data->vtext()),
 				Api::EntitiesFromMTP(session, data->ventities().v)
 			} : TextWithEntities();
+			Data::SaveCachedTranslation(item, to, text);
 			item->translationDone(to, std::move(text));
 		}
 		++index;
@@ -320,12 +429,20 @@ void TranslateTracker::applyLimit() {
 		for (auto i = begin(_itemsForRecognize)
 			; i != end(_itemsForRecognize);) {
 			if (i->second.generation == oldest) {
-				if (const auto j = _itemsToRequest.find(i->first)
-					; j != end(_itemsToRequest)) {
+				const auto j = _itemsToRequest.find(i->first);
+				const auto k = _itemsInCacheLookup.find(i->first);
+				const auto waiting = (j != end(_itemsToRequest));
+				const auto looking = (k != end(_itemsInCacheLookup));
+				if (waiting || looking) {
 					if (const auto item = owner->message(i->first)) {
 						item->translationShowRequiresRequest({});
 					}
-					_itemsToRequest.erase(j);
+					if (waiting) {
+						_itemsToRequest.erase(j);
+					}
+					if (looking) {
+						_itemsInCacheLookup.erase(k);
+					}
 				}
 				i = _itemsForRecognize.erase(i);
 			} else {
@@ -336,11 +453,58 @@ void TranslateTracker::applyLimit() {
 }
 
 void TranslateTracker::recognizeCollected() {
-	for (auto &[id, entry] : _itemsForRecognize) {
+	if (_recognizing) {
+		return;
+	}
+	auto texts = std::vector<std::pair<FullMsgId, QString>>();
+	for (const auto &[id, entry] : _itemsForRecognize) {
 		if (const auto text = std::get_if<QString>(&entry.id)) {
-			entry.id = Platform::Language::Recognize(*text);
+			texts.emplace_back(id, *text);
+		}
+	}
+	if (texts.empty()) {
+		return;
+	}
+	_recognizing = true;
+	crl::async([=, weak = base::make_weak(this)]() mutable {
+		const auto started = crl::now();
+		auto ids = std::vector<LanguageId>();
+		ids.reserve(texts.size());
+		for (const auto &[id, text] : texts) {
+			ids.push_back(Platform::Language::Recognize(text));
+		}
+		DEBUG_LOG(("Translate Info: Recognized %1 texts in %2 ms."
+			).arg(texts.size()
+			).arg(crl::now() - started));
+		crl::on_main(weak, [=, texts = std::move(texts)]() mutable {
+			weak->recognized(std::move(texts), std::move(ids));
+		});
+	});
+}
+
+void TranslateTracker::recognized(
+		std::vector<std::pair<FullMsgId, QString>> texts,
+		std::vector<LanguageId> ids) {
+	Expects(texts.size() == ids.size());
+
+	_recognizing = false;
+	for (auto i = 0, count = int(texts.size()); i != count; ++i) {
+		const auto &[id, text] = texts[i];
+		Recognized().add(id, text, ids[i]);
+
+		const auto j = _itemsForRecognize.find(id);
+		if (j != end(_itemsForRecognize)) {
+			const auto was = std::get_if<QString>(&j->second.id);
+			if (was && *was == text) {
+				j->second.id = ids[i];
+			}
 		}
 	}
+	if (!_trackingLanguage.current()) {
+		return;
+	}
+	recognizeCollected();
+	checkRecognized();
 }
 
 void TranslateTracker::trackSkipLanguages() {
@@ -359,6 +523,10 @@ void TranslateTracker::checkRecognized(const std::vector<LanguageId> &skip) {
 		_history->translateOfferFrom({});
 		return;
 	}
+	if (_recognizing) {
+		// Will be checked again when the recognition is finished.
+		return;
+	}
 	auto languages = base::flat_map<LanguageId, int>();
 	for (const auto &[id, entry] : _itemsForRecognize) {
 		if (const auto id = std::get_if<LanguageId>(&entry.id)) {
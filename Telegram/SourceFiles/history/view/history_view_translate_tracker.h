@@ -7,6 +7,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #pragma once
 
+#include "base/weak_ptr.h"
 #include "spellcheck/spellcheck_types.h"
 
 class History;
@@ -16,7 +17,7 @@ namespace HistoryView {
 
 class Element;
 
-class TranslateTracker final {
+class TranslateTracker final : public base::has_weak_ptr {
 public:
 	explicit TranslateTracker(not_null<History*> history);
 	~TranslateTracker();
@@ -41,10 +42,17 @@ private:
 	struct ItemToRequest {
 		int length = 0;
 	};
+	struct ItemInCacheLookup {
+		LanguageId to;
+		int length = 0;
+	};
 
 	void setup();
 	bool add(not_null<HistoryItem*> item, bool skipDependencies);
 	void recognizeCollected();
+	void recognized(
+		std::vector<std::pair<FullMsgId, QString>> texts,
+		std::vector<LanguageId> ids);
 	void trackSkipLanguages();
 	void checkRecognized();
 	void checkRecognized(const std::vector<LanguageId> &skip);
@@ -53,6 +61,10 @@ private:
 	void cancelToRequest();
 	void cancelSentRequest();
 	void switchTranslation(not_null<HistoryItem*> item, LanguageId id);
+	void cacheLookupDone(
+		FullMsgId id,
+		LanguageId to,
+		TextWithEntities &&text);
 
 	void requestDone(
 		LanguageId to,
@@ -66,8 +78,10 @@ private:
 	int _limit = 0;
 	int _addedInBunch = -1;
 	bool _allLoaded = false;
+	bool _recognizing = false;
 
 	base::flat_map<not_null<HistoryItem*>, LanguageId> _switchTranslations;
+	base::flat_map<FullMsgId, ItemInCacheLookup> _itemsInCacheLookup;
 	base::flat_map<FullMsgId, ItemToRequest> _itemsToRequest;
 	std::vector<FullMsgId> _requested;
 	mtpRequestId _requestId = 0;
@@ -523,10 +523,15 @@ void Sticker::setupPlayer() {
 				countOptimalSize() * style::DevicePixelRatio(),
 				Lottie::Quality::High));
 	} else if (_data->sticker()->isWebm()) {
+		const auto size = countOptimalSize();
 		_player = std::make_unique<WebmPlayer>(
 			_dataMedia->owner()->location(),
 			_dataMedia->bytes(),
-			countOptimalSize());
+			size,
+			ChatHelpers::WebmFramesCacheFromDocument(
+				_dataMedia.get(),
+				_cachingTag,
+				size * style::DevicePixelRatio()));
 	}
 
 	checkPremiumEffectStart();
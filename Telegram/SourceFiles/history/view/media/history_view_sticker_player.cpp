@@ -7,7 +7,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "history/view/media/history_view_sticker_player.h"
 
-#include "core/file_location.h"
+#include "lottie/lottie_common.h"
+#include "ui/image/image_prepare.h"
 
 namespace HistoryView {
 namespace {
@@ -61,12 +62,69 @@ bool LottiePlayer::markFrameShown() {
 WebmPlayer::WebmPlayer(
 	const Core::FileLocation &location,
 	const QByteArray &data,
-	QSize size)
-: _reader(
-	::Media::Clip::MakeReader(location, data, [=](ClipNotification update) {
-	clipCallback(update);
-}))
+	QSize size,
+	::Media::Clip::FramesCacheDescriptor cache)
+: _location(location)
+, _data(data)
+, _cache(std::move(cache))
+, _cachedTimer([=] { repaint(); })
 , _size(size) {
+	if (!_cache) {
+		createReader();
+		return;
+	}
+	const auto box = _size * style::DevicePixelRatio();
+	const auto weak = base::make_weak(this);
+	_cache.get([=](QByteArray &&value) {
+		using FramesCache = ::Media::Clip::FramesCache;
+		auto cached = FramesCache::FromSerialized(value, box);
+		const auto uncacheable = !cached
+			&& FramesCache::IsUncacheable(value, box);
+		crl::on_main(weak, [=, result = std::move(cached)]() mutable {
+			cacheLookupDone(std::move(result), uncacheable);
+		});
+	});
+}
+
+void WebmPlayer::cacheLookupDone(
+		std::unique_ptr<::Media::Clip::FramesCache> cached,
+		bool uncacheable) {
+	if (cached) {
+		_cached = std::move(cached);
+		repaint();
+	} else {
+		createReader();
+		if (!uncacheable) {
+			prepareCache();
+		}
+	}
+}
+
+void WebmPlayer::createReader() {
+	_reader = ::Media::Clip::MakeReader(
+		_location,
+		_data,
+		[=](ClipNotification update) { clipCallback(update); });
+}
+
+void WebmPlayer::prepareCache() {
+	if (_cache.startPreparing && !_cache.startPreparing()) {
+		return;
+	}
+	crl::async([
+		put = _cache.put,
+		path = _location.name(),
+		data = _data,
+		box = _size * style::DevicePixelRatio()
+	] {
+		using FramesCache = ::Media::Clip::FramesCache;
+		auto prepared = FramesCache::Prepare(
+			Lottie::ReadContent(data, path),
+			box);
+		put(prepared.uncacheable
+			? FramesCache::SerializeUncacheable(box)
+			: std::move(prepared.serialized));
+	});
 }
 
 void WebmPlayer::clipCallback(ClipNotification notification) {
@@ -82,7 +140,13 @@ void WebmPlayer::clipCallback(ClipNotification notification) {
 	case ClipNotification::Repaint: break;
 	}
 
-	_repaintCallback();
+	repaint();
+}
+
+void WebmPlayer::repaint() {
+	if (_repaintCallback) {
+		_repaintCallback();
+	}
 }
 
 void WebmPlayer::setRepaintCallback(Fn<void()> callback) {
@@ -90,11 +154,11 @@ void WebmPlayer::setRepaintCallback(Fn<void()> callback) {
 }
 
 bool WebmPlayer::ready() {
-	return _reader && _reader->started();
+	return _cached || (_reader && _reader->started());
 }
 
 int WebmPlayer::framesCount() {
-	return -1;
+	return _cached ? _cached->count() : -1;
 }
 
 WebmPlayer::FrameInfo WebmPlayer::frame(
@@ -103,6 +167,11 @@ WebmPlayer::FrameInfo WebmPlayer::frame(
 		bool mirrorHorizontal,
 		crl::time now,
 		bool paused) {
+	if (_cached) {
+		return cachedFrame(size, colored);
+	} else if (!_reader) {
+		return {};
+	}
 	auto request = ::Media::Clip::FrameRequest();
 	request.frame = size;
 	request.factor = style::DevicePixelRatio();
@@ -112,8 +181,59 @@ WebmPlayer::FrameInfo WebmPlayer::frame(
 	return { .image = info.image, .index = info.index };
 }
 
+WebmPlayer::FrameInfo WebmPlayer::cachedFrame(QSize size, QColor colored) {
+	auto image = _cached->frame(_cachedIndex);
+	if (image.isNull()) {
+		_cached = nullptr;
+		_cachedTimer.cancel();
+		createReader();
+		return {};
+	}
+	const auto box = size * style::DevicePixelRatio();
+	if (image.size() != box) {
+		image = image.scaled(
+			box,
+			Qt::IgnoreAspectRatio,
+			Qt::SmoothTransformation);
+	}
+	if (colored.alpha() == 0) {
+		return { .image = std::move(image), .index = _cachedIndex };
+	} else if (_cachedColoredIndex != _cachedIndex
+		|| _cachedColoredBy != colored
+		|| _cachedColored.size() != box) {
+		_cachedColored = Images::Colored(std::move(image), colored);
+		_cachedColoredIndex = _cachedIndex;
+		_cachedColoredBy = colored;
+	}
+	return { .image = _cachedColored, .index = _cachedIndex };
+}
+
 bool WebmPlayer::markFrameShown() {
-	return _reader->moveToNextFrame();
+	if (_cached) {
+		return markCachedFrameShown();
+	}
+	return _reader && _reader->moveToNextFrame();
+}
+
+bool WebmPlayer::markCachedFrameShown() {
+	const auto now = crl::now();
+	auto switched = false;
+	if (!_cachedNextAt) {
+		_cachedNextAt = now + _cached->duration(_cachedIndex);
+	} else if (now < _cachedNextAt) {
+		return false;
+	} else {
+		_cachedIndex = (_cachedIndex + 1) % _cached->count();
+		const auto duration = _cached->duration(_cachedIndex);
+
+		// Don't try to catch up after a pause, just continue from here.
+		_cachedNextAt = (now - _cachedNextAt < duration)
+			? (_cachedNextAt + duration)
+			: (now + duration);
+		switched = true;
+	}
+	_cachedTimer.callOnce(std::max(_cachedNextAt - now, crl::time(1)));
+	return switched;
 }
 
 StaticStickerPlayer::StaticStickerPlayer(
@@ -9,13 +9,13 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "history/view/media/history_view_sticker_player_abstract.h"
 
+#include "base/timer.h"
+#include "base/weak_ptr.h"
+#include "core/file_location.h"
 #include "lottie/lottie_single_player.h"
+#include "media/clip/media_clip_frames_cache.h"
 #include "media/clip/media_clip_reader.h"
 
-namespace Core {
-class FileLocation;
-} // namespace Core
-
 namespace HistoryView {
 
 class LottiePlayer final : public StickerPlayer {
@@ -39,12 +39,15 @@ private:
 
 };
 
-class WebmPlayer final : public StickerPlayer {
+class WebmPlayer final
+	: public StickerPlayer
+	, public base::has_weak_ptr {
 public:
 	WebmPlayer(
 		const Core::FileLocation &location,
 		const QByteArray &data,
-		QSize size);
+		QSize size,
+		::Media::Clip::FramesCacheDescriptor cache = {});
 
 	void setRepaintCallback(Fn<void()> callback) override;
 	bool ready() override;
@@ -59,8 +62,26 @@ public:
 
 private:
 	void clipCallback(::Media::Clip::Notification notification);
-
+	void cacheLookupDone(
+		std::unique_ptr<::Media::Clip::FramesCache> cached,
+		bool uncacheable);
+	void createReader();
+	void prepareCache();
+	[[nodiscard]] FrameInfo cachedFrame(QSize size, QColor colored);
+	bool markCachedFrameShown();
+	void repaint();
+
+	Core::FileLocation _location;
+	QByteArray _data;
 	::Media::Clip::ReaderPointer _reader;
+	::Media::Clip::FramesCacheDescriptor _cache;
+	std::unique_ptr<::Media::Clip::FramesCache> _cached;
+	QImage _cachedColored;
+	QColor _cachedColoredBy;
+	int _cachedColoredIndex = -1;
+	int _cachedIndex = 0;
+	crl::time _cachedNextAt = 0;
+	base::Timer _cachedTimer;
 	Fn<void()> _repaintCallback;
 	QSize _size;
 
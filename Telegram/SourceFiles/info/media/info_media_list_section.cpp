@@ -31,6 +31,10 @@ bool ListSection::empty() const {
 	return _items.empty();
 }
 
+bool ListSection::sameItems(const ListSection &other) const {
+	return (_type == other._type) && (_items == other._items);
+}
+
 UniversalMsgId ListSection::minId() const {
 	Expects(!empty());
 
@@ -91,12 +95,14 @@ bool ListSection::belongsHere(
 void ListSection::appendItem(not_null<BaseLayout*> item) {
 	_items.push_back(item);
 	_byItem.emplace(item->getItem(), item);
+	invalidateLayout();
 }
 
 bool ListSection::removeItem(not_null<const HistoryItem*> item) {
 	if (const auto i = _byItem.find(item); i != end(_byItem)) {
 		_items.erase(ranges::remove(_items, i->second), end(_items));
 		_byItem.erase(i);
+		invalidateLayout();
 		refreshHeight();
 		return true;
 	}
@@ -267,6 +273,26 @@ void ListSection::paint(
 	}
 }
 
+void ListSection::preloadItems(int fromTop, int tillBottom) const {
+	if (_items.empty() || tillBottom <= fromTop) {
+		return;
+	}
+	const auto clip = QRect(0, fromTop, _width, tillBottom - fromTop);
+	if (!_mosaic.empty()) {
+		for (const auto &item : _items) {
+			if (findItemRect(item).intersects(clip)) {
+				item->preload();
+			}
+		}
+		return;
+	}
+	const auto fromIt = findItemAfterTop(fromTop);
+	const auto tillIt = findItemAfterBottom(fromIt, tillBottom);
+	for (auto it = fromIt; it != tillIt; ++it) {
+		(*it)->preload();
+	}
+}
+
 void ListSection::paintFloatingHeader(
 		Painter &p,
 		int visibleTop,
@@ -325,7 +351,12 @@ void ListSection::resizeToWidth(int newWidth) {
 	auto minWidth = st::infoMediaMinGridSize + st::infoMediaSkip * 2;
 	if (newWidth < minWidth) {
 		return;
+	} else if (_width == newWidth) {
+		// Items were not changed since the last layout,
+		// otherwise invalidateLayout() would have reset the width.
+		return;
 	}
+	_width = newWidth;
 
 	auto resizeOneColumn = [&](int itemsLeft, int itemWidth) {
 		_itemsLeft = itemsLeft;
@@ -374,6 +405,10 @@ void ListSection::resizeToWidth(int newWidth) {
 	refreshHeight();
 }
 
+void ListSection::invalidateLayout() {
+	_width = 0;
+}
+
 int ListSection::recountHeight() {
 	auto result = headerHeight();
 
@@ -21,12 +21,14 @@ public:
 	void finishSection();
 
 	[[nodiscard]] bool empty() const;
+	[[nodiscard]] bool sameItems(const ListSection &other) const;
 
 	[[nodiscard]] UniversalMsgId minId() const;
 
 	void setTop(int top);
 	[[nodiscard]] int top() const;
 	void resizeToWidth(int newWidth);
+	void invalidateLayout();
 	[[nodiscard]] int height() const;
 
 	[[nodiscard]] int bottom() const;
@@ -49,6 +51,8 @@ public:
 
 	void paintFloatingHeader(Painter &p, int visibleTop, int outerWidth);
 
+	void preloadItems(int fromTop, int tillBottom) const;
+
 private:
 	[[nodiscard]] int headerHeight() const;
 	void appendItem(not_null<BaseLayout*> item);
@@ -85,6 +89,7 @@ private:
 	int _itemHeight = 0;
 	int _itemsInRow = 1;
 	mutable int _rowsCount = 0;
+	int _width = 0;
 	int _top = 0;
 	int _height = 0;
 
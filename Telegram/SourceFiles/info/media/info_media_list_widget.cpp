@@ -417,6 +417,13 @@ bool ListWidget::hasSelectedItems() const {
 
 void ListWidget::itemLayoutChanged(
 		not_null<const HistoryItem*> item) {
+	if (_provider->isMyItem(item)) {
+		const auto section = findSectionByItem(item);
+		if (section != _sections.end() && section->findItemByItem(item)) {
+			section->invalidateLayout();
+			resizeToWidth(width());
+		}
+	}
 	if (isItemLayout(item, _overLayout)) {
 		mouseActionUpdate();
 	}
@@ -530,8 +537,9 @@ void ListWidget::trackSession(not_null<Main::Session*> session) {
 void ListWidget::refreshRows() {
 	saveScrollState();
 
-	_sections.clear();
-	_sections = _provider->fillSections(this);
+	auto sections = _provider->fillSections(this);
+	reuseUnchangedSections(sections);
+	_sections = std::move(sections);
 
 	if (_controller->isDownloads() && !_sections.empty()) {
 		for (const auto &item : _sections.back().items()) {
@@ -551,6 +559,26 @@ void ListWidget::refreshRows() {
 	update();
 }
 
+void ListWidget::reuseUnchangedSections(std::vector<Section> &sections) {
+	// Sections that got exactly the same layouts keep their geometry,
+	// so that only the changed part of the list is laid out again.
+	if (_sections.empty()) {
+		return;
+	}
+	auto old = _sections.begin();
+	for (auto &section : sections) {
+		while (old != _sections.end() && old->minId() > section.minId()) {
+			++old;
+		}
+		if (old == _sections.end()) {
+			break;
+		} else if (old->sameItems(section)) {
+			section = std::move(*old++);
+		}
+	}
+	_sections.clear();
+}
+
 bool ListWidget::preventAutoHide() const {
 	return (_contextMenu != nullptr) || (_actionBoxWeak != nullptr);
 }
@@ -623,11 +651,13 @@ auto ListWidget::foundItemInSection(
 void ListWidget::visibleTopBottomUpdated(
 		int visibleTop,
 		int visibleBottom) {
+	const auto scrolledDown = (visibleTop >= _visibleTop);
 	_visibleTop = visibleTop;
 	_visibleBottom = visibleBottom;
 
 	checkMoveToOtherViewer();
 	clearHeavyItems();
+	preloadAlongScroll(scrolledDown);
 
 	if (_dateBadge->goodType) {
 		updateDateBadgeFor(_visibleTop);
@@ -732,6 +762,29 @@ void ListWidget::clearHeavyItems() {
 	}
 }
 
+void ListWidget::preloadAlongScroll(bool scrolledDown) {
+	const auto visibleHeight = _visibleBottom - _visibleTop;
+	if (!visibleHeight || _sections.empty()) {
+		return;
+	}
+	// Request thumbnails for one screen ahead in the scroll direction,
+	// clearHeavyItems() keeps exactly that much around the viewport.
+	const auto from = scrolledDown
+		? _visibleBottom
+		: (_visibleTop - visibleHeight);
+	const auto till = scrolledDown
+		? (_visibleBottom + visibleHeight)
+		: _visibleTop;
+	for (const auto &section : _sections) {
+		if (section.bottom() <= from) {
+			continue;
+		} else if (section.top() >= till) {
+			break;
+		}
+		section.preloadItems(from - section.top(), till - section.top());
+	}
+}
+
 ListScrollTopState ListWidget::countScrollState() const {
 	if (_sections.empty() || _visibleTop <= 0) {
 		return {};
@@ -265,6 +265,8 @@ private:
 	void validateTrippleClickStartTime();
 	void checkMoveToOtherViewer();
 	void clearHeavyItems();
+	void preloadAlongScroll(bool scrolledDown);
+	void reuseUnchangedSections(std::vector<Section> &sections);
 
 	void setActionBoxWeak(QPointer<Ui::BoxContent> box);
 
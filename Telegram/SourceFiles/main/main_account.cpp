@@ -495,6 +495,10 @@ void Account::startMtp(std::unique_ptr<MTP::Config> config) {
 }
 
 bool Account::checkForUpdates(const MTP::Response &message) {
+	if (const auto parsed = std::any_cast<MTPUpdates>(&message.parsed)) {
+		_mtpUpdates.fire_copy(*parsed);
+		return true;
+	}
 	auto updates = MTPUpdates();
 	auto from = message.reply.constData();
 	if (!updates.read(from, from + message.reply.size())) {
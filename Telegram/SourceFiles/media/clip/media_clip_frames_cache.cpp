@@ -0,0 +1,241 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "media/clip/media_clip_frames_cache.h"
+
+#include "ffmpeg/ffmpeg_frame_generator.h"
+#include "logs.h"
+
+#include <QtCore/QDataStream>
+
+namespace Media {
+namespace Clip {
+namespace {
+
+constexpr auto kVersion = quint32(1);
+constexpr auto kMaxFrames = 180;
+constexpr auto kMaxArea = 512 * 512;
+constexpr auto kMaxSerializedSize = 10 * 1024 * 1024;
+constexpr auto kDefaultFrameDuration = crl::time(33);
+constexpr auto kCompressionLevel = 1;
+
+void XorLines(
+		uchar *to,
+		int toPerLine,
+		const uchar *from,
+		int fromPerLine,
+		QSize size) {
+	const auto ints = size.width();
+	for (auto y = 0; y != size.height(); ++y) {
+		const auto dst = reinterpret_cast<uint32*>(to);
+		const auto src = reinterpret_cast<const uint32*>(from);
+		for (auto x = 0; x != ints; ++x) {
+			dst[x] ^= src[x];
+		}
+		to += toPerLine;
+		from += fromPerLine;
+	}
+}
+
+[[nodiscard]] bool ReadHeader(QDataStream &stream, QSize size) {
+	auto version = quint32();
+	auto width = qint32();
+	auto height = qint32();
+	stream >> version >> width >> height;
+	return (stream.status() == QDataStream::Ok)
+		&& (version == kVersion)
+		&& (QSize(width, height) == size);
+}
+
+} // namespace
+
+auto FramesCache::Prepare(const QByteArray &content, QSize size)
+-> Prepared {
+	const auto uncacheable = Prepared{ .uncacheable = true };
+	if (content.isEmpty()) {
+		// The file may be not readable yet, try again next time.
+		return {};
+	} else if (size.isEmpty() || size.width() * size.height() > kMaxArea) {
+		return uncacheable;
+	}
+	auto generator = FFmpeg::FrameGenerator(content);
+
+	auto result = QByteArray();
+	auto stream = QDataStream(&result, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_1);
+	stream << kVersion << qint32(size.width()) << qint32(size.height());
+
+	const auto perLine = size.width() * 4;
+	auto previous = QByteArray(perLine * size.height(), char(0));
+	auto delta = QByteArray();
+	auto storage = QImage();
+	for (auto index = 0; index != kMaxFrames; ++index) {
+		auto frame = generator.renderNext(
+			std::move(storage),
+			size,
+			Qt::KeepAspectRatio);
+		if (frame.image.isNull()) {
+			return {};
+		} else if (frame.image.size() != size
+			|| (frame.image.format()
+				!= QImage::Format_ARGB32_Premultiplied)) {
+			return uncacheable;
+		}
+
+		// Keep the new frame in previous, write the difference to delta.
+		delta = previous;
+		XorLines(
+			reinterpret_cast<uchar*>(delta.data()),
+			perLine,
+			frame.image.constBits(),
+			frame.image.bytesPerLine(),
+			size);
+		XorLines(
+			reinterpret_cast<uchar*>(previous.data()),
+			perLine,
+			reinterpret_cast<const uchar*>(delta.constData()),
+			perLine,
+			size);
+
+		const auto compressed = qCompress(delta, kCompressionLevel);
+		const auto duration = (frame.duration > 0)
+			? frame.duration
+			: kDefaultFrameDuration;
+		stream << qint32(duration) << qint32(compressed.size());
+		stream.writeRawData(compressed.constData(), compressed.size());
+		if (stream.status() != QDataStream::Ok) {
+			return {};
+		} else if (result.size() > kMaxSerializedSize) {
+			return uncacheable;
+		} else if (frame.last) {
+			return { .serialized = result };
+		}
+		storage = std::move(frame.image);
+	}
+	return uncacheable;
+}
+
+std::unique_ptr<FramesCache> FramesCache::FromSerialized(
+		const QByteArray &serialized,
+		QSize size) {
+	if (serialized.isEmpty()) {
+		return nullptr;
+	}
+	auto stream = QDataStream(serialized);
+	stream.setVersion(QDataStream::Qt_5_1);
+	if (!ReadHeader(stream, size)) {
+		return nullptr;
+	}
+	auto entries = std::vector<Entry>();
+	while (!stream.atEnd()) {
+		auto duration = qint32();
+		auto length = qint32();
+		stream >> duration >> length;
+		const auto offset = int(stream.device()->pos());
+		if (stream.status() != QDataStream::Ok
+			|| duration <= 0
+			|| length <= 0
+			|| stream.skipRawData(length) != length) {
+			return nullptr;
+		}
+		entries.push_back({
+			.offset = offset,
+			.length = length,
+			.duration = duration,
+		});
+	}
+	if (entries.empty()) {
+		return nullptr;
+	}
+	return std::unique_ptr<FramesCache>(
+		new FramesCache(serialized, size, std::move(entries)));
+}
+
+QByteArray FramesCache::SerializeUncacheable(QSize size) {
+	auto result = QByteArray();
+	auto stream = QDataStream(&result, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_1);
+	stream << kVersion << qint32(size.width()) << qint32(size.height());
+	return result;
+}
+
+bool FramesCache::IsUncacheable(const QByteArray &serialized, QSize size) {
+	if (serialized.isEmpty()) {
+		return false;
+	}
+	auto stream = QDataStream(serialized);
+	stream.setVersion(QDataStream::Qt_5_1);
+	return ReadHeader(stream, size) && stream.atEnd();
+}
+
+FramesCache::FramesCache(
+	QByteArray data,
+	QSize size,
+	std::vector<Entry> entries)
+: _data(std::move(data))
+, _size(size)
+, _entries(std::move(entries)) {
+}
+
+QSize FramesCache::size() const {
+	return _size;
+}
+
+int FramesCache::count() const {
+	return int(_entries.size());
+}
+
+crl::time FramesCache::duration(int index) const {
+	Expects(index >= 0 && index < count());
+
+	return _entries[index].duration;
+}
+
+QImage FramesCache::frame(int index) {
+	Expects(index >= 0 && index < count());
+
+	if (index < _index) {
+		_index = -1;
+	}
+	while (_index < index) {
+		if (!applyNext()) {
+			_index = -1;
+			return QImage();
+		}
+	}
+	return _frame;
+}
+
+bool FramesCache::applyNext() {
+	const auto index = _index + 1;
+	const auto &entry = _entries[index];
+	const auto delta = qUncompress(
+		reinterpret_cast<const uchar*>(_data.constData() + entry.offset),
+		entry.length);
+	const auto perLine = _size.width() * 4;
+	if (delta.size() != perLine * _size.height()) {
+		LOG(("Media Error: Bad frame %1 in frames cache.").arg(index));
+		return false;
+	}
+	if (_frame.isNull()) {
+		_frame = QImage(_size, QImage::Format_ARGB32_Premultiplied);
+	}
+	if (!index) {
+		_frame.fill(Qt::transparent);
+	}
+	XorLines(
+		_frame.bits(),
+		_frame.bytesPerLine(),
+		reinterpret_cast<const uchar*>(delta.constData()),
+		perLine,
+		_size);
+	_index = index;
+	return true;
+}
+
+} // namespace Clip
+} // namespace Media
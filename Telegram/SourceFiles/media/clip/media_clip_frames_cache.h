@@ -0,0 +1,85 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include <QtGui/QImage>
+
+namespace Media {
+namespace Clip {
+
+struct FramesCacheDescriptor {
+	Fn<void(FnMut<void(QByteArray &&cached)>)> get;
+	Fn<void(QByteArray &&cached)> put;
+
+	// Returns false if the same frames are already being prepared,
+	// otherwise put() is expected to be called once they're ready.
+	// An empty value passed to put() only finishes the preparation.
+	Fn<bool()> startPreparing;
+
+	explicit operator bool() const {
+		return get && put;
+	}
+};
+
+// Pre-rendered frames of a short video with alpha, like a WebM sticker.
+// Each frame is stored as a compressed xor-difference with the previous
+// one, so frames are restored sequentially, going back starts from zero.
+class FramesCache final {
+public:
+	struct Prepared {
+		QByteArray serialized;
+
+		// Set if the content will never fit in the cache, for example
+		// if it has too many frames. Not set if it could not be read.
+		bool uncacheable = false;
+	};
+
+	// Heavy, should be called from a background thread.
+	// Returns an empty serialized value if the content can't be cached.
+	[[nodiscard]] static Prepared Prepare(
+		const QByteArray &content,
+		QSize size);
+	[[nodiscard]] static std::unique_ptr<FramesCache> FromSerialized(
+		const QByteArray &serialized,
+		QSize size);
+
+	// Stored instead of the frames if Prepare() found the content
+	// uncacheable, so that it is not attempted on each display again.
+	[[nodiscard]] static QByteArray SerializeUncacheable(QSize size);
+	[[nodiscard]] static bool IsUncacheable(
+		const QByteArray &serialized,
+		QSize size);
+
+	[[nodiscard]] QSize size() const;
+	[[nodiscard]] int count() const;
+	[[nodiscard]] crl::time duration(int index) const;
+
+	// Returns a null image if the cached data is corrupted.
+	[[nodiscard]] QImage frame(int index);
+
+private:
+	struct Entry {
+		int offset = 0;
+		int length = 0;
+		crl::time duration = 0;
+	};
+
+	FramesCache(QByteArray data, QSize size, std::vector<Entry> entries);
+
+	bool applyNext();
+
+	QByteArray _data;
+	QSize _size;
+	std::vector<Entry> _entries;
+	QImage _frame;
+	int _index = -1;
+
+};
+
+} // namespace Clip
+} // namespace Media
@@ -435,10 +435,7 @@ void ReplyArea::chooseAttach(
 			}
 		} else {
 			const auto premium = session().premium();
-			auto list = Storage::PrepareMediaList(
-				result.paths,
-				st::sendMediaPreviewSize,
-				premium);
+			auto list = Storage::CollectMediaList(result.paths, premium);
 			list.overrideSendImagesAsPhotos = overrideSendImagesAsPhotos;
 			confirmSendingFiles(std::move(list));
 		}
@@ -461,10 +458,7 @@ bool ReplyArea::confirmSendingFiles(
 	const auto premium = session().user()->isPremium();
 
 	if (const auto urls = Core::ReadMimeUrls(data); !urls.empty()) {
-		auto list = Storage::PrepareMediaList(
-			urls,
-			st::sendMediaPreviewSize,
-			premium);
+		auto list = Storage::CollectMediaList(urls, premium);
 		if (list.error != Ui::PreparedList::Error::NonLocalUrl) {
 			if (list.error == Ui::PreparedList::Error::None
 				|| !hasImage) {
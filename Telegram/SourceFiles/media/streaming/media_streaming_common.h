@@ -190,5 +190,11 @@ struct FrameWithInfo {
 	bool alpha = false;
 };
 
+struct FrameStatistics {
+	int shown = 0;
+	int dropped = 0; // Decoded, but skipped because of being stale.
+	int late = 0; // Displayed noticeably later than planned.
+};
+
 } // namespace Streaming
 } // namespace Media
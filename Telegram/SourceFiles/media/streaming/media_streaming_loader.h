@@ -42,6 +42,11 @@ public:
 	// Parts will be sent from the main thread.
 	[[nodiscard]] virtual rpl::producer<LoadedPart> parts() const = 0;
 
+	// Whole file contents, if they can be read directly from any thread.
+	[[nodiscard]] virtual bytes::const_span mapped() const {
+		return {};
+	}
+
 	virtual void attachDownloader(
 		not_null<Storage::StreamedFileDownloader*> downloader) = 0;
 	virtual void clearAttachedDownloader() = 0;
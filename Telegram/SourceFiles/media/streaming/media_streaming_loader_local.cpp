@@ -10,6 +10,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "storage/cache/storage_cache_types.h"
 
 #include <QtCore/QBuffer>
+#include <QtCore/QFile>
 
 namespace Media {
 namespace Streaming {
@@ -24,13 +25,34 @@ constexpr auto kMaxFileSize = 8000 * int64(512 * 1024);
 
 } // namespace
 
-LoaderLocal::LoaderLocal(std::unique_ptr<QIODevice> device)
+LoaderLocal::LoaderLocal(std::unique_ptr<QIODevice> device, bool mappable)
 : _device(std::move(device))
 , _size(ValidateLocalSize(_device->size())) {
 	Expects(_device != nullptr);
 
 	if (!_size || !_device->open(QIODevice::ReadOnly)) {
 		fail();
+	} else {
+		map(mappable);
+	}
+}
+
+void LoaderLocal::map(bool mappable) {
+	// The mapping lives while the device is open, so the reader can take
+	// bytes right on the streaming thread, without parts and main thread.
+	// Other files are read by parts through the device.
+	if (const auto file = dynamic_cast<QFile*>(_device.get())) {
+		if (!mappable) {
+			return;
+		}
+		if (const auto data = file->map(0, _size)) {
+			_mapped = bytes::make_span(data, _size);
+		}
+	} else if (const auto buffer = dynamic_cast<QBuffer*>(_device.get())) {
+		const auto &data = buffer->data();
+		if (data.size() == _size) {
+			_mapped = bytes::make_span(data);
+		}
 	}
 }
 
@@ -84,6 +106,10 @@ rpl::producer<LoadedPart> LoaderLocal::parts() const {
 	return _parts.events();
 }
 
+bytes::const_span LoaderLocal::mapped() const {
+	return _mapped;
+}
+
 void LoaderLocal::attachDownloader(
 		not_null<Storage::StreamedFileDownloader*> downloader) {
 	Unexpected("Downloader attached to a local streaming loader.");
@@ -93,8 +119,12 @@ void LoaderLocal::clearAttachedDownloader() {
 	Unexpected("Downloader detached from a local streaming loader.");
 }
 
-std::unique_ptr<LoaderLocal> MakeFileLoader(const QString &path) {
-	return std::make_unique<LoaderLocal>(std::make_unique<QFile>(path));
+std::unique_ptr<LoaderLocal> MakeFileLoader(
+		const QString &path,
+		bool mappable) {
+	return std::make_unique<LoaderLocal>(
+		std::make_unique<QFile>(path),
+		mappable);
 }
 
 std::unique_ptr<LoaderLocal> MakeBytesLoader(const QByteArray &bytes) {
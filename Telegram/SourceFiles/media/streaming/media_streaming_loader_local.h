@@ -18,7 +18,8 @@ namespace Streaming {
 
 class LoaderLocal : public Loader, public base::has_weak_ptr {
 public:
-	LoaderLocal(std::unique_ptr<QIODevice> device);
+	// Files are mapped only if mappable, see MakeFileLoader.
+	LoaderLocal(std::unique_ptr<QIODevice> device, bool mappable = false);
 
 	[[nodiscard]] Storage::Cache::Key baseCacheKey() const override;
 	[[nodiscard]] int64 size() const override;
@@ -33,6 +34,7 @@ public:
 
 	// Parts will be sent from the main thread.
 	[[nodiscard]] rpl::producer<LoadedPart> parts() const override;
+	[[nodiscard]] bytes::const_span mapped() const override;
 
 	void attachDownloader(
 		not_null<Storage::StreamedFileDownloader*> downloader) override;
@@ -40,14 +42,19 @@ public:
 
 private:
 	void fail();
+	void map(bool mappable);
 
 	const std::unique_ptr<QIODevice> _device;
 	const int64 _size = 0;
+	bytes::const_span _mapped;
 	rpl::event_stream<LoadedPart> _parts;
 
 };
 
-std::unique_ptr<LoaderLocal> MakeFileLoader(const QString &path);
+// Pass mappable only for files no other process is expected to truncate.
+std::unique_ptr<LoaderLocal> MakeFileLoader(
+	const QString &path,
+	bool mappable = false);
 std::unique_ptr<LoaderLocal> MakeBytesLoader(const QByteArray &bytes);
 
 } // namespace Streaming
@@ -913,6 +913,10 @@ QImage Player::currentFrameImage() const {
 	return _video->currentFrameImage();
 }
 
+FrameStatistics Player::videoFrameStatistics() const {
+	return _video ? _video->frameStatistics() : FrameStatistics();
+}
+
 void Player::unregisterInstance(not_null<const Instance*> instance) {
 	if (_video) {
 		_video->unregisterInstance(instance);
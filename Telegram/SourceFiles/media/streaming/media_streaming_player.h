@@ -71,6 +71,7 @@ public:
 		const Instance *instance = nullptr) const; // !requireARGB32
 
 	[[nodiscard]] QImage currentFrameImage() const; // Converts if needed.
+	[[nodiscard]] FrameStatistics videoFrameStatistics() const;
 
 	void unregisterInstance(not_null<const Instance*> instance);
 	bool markFrameShown();
@@ -10,6 +10,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "media/streaming/media_streaming_common.h"
 #include "media/streaming/media_streaming_loader.h"
 #include "storage/cache/storage_cache_database.h"
+#include "storage/storage_cache_lookups.h"
 
 namespace Media {
 namespace Streaming {
@@ -840,9 +841,11 @@ Reader::SerializedSlice Reader::Slices::unloadToCache() {
 
 Reader::Reader(
 	std::unique_ptr<Loader> loader,
-	Storage::Cache::Database *cache)
+	Storage::Cache::Database *cache,
+	std::shared_ptr<Storage::CacheLookups> cacheLookups)
 : _loader(std::move(loader))
 , _cache(cache)
+, _cacheLookups(std::move(cacheLookups))
 , _cacheHelper(cache ? InitCacheHelper(_loader->baseCacheKey()) : nullptr)
 , _slices(_loader->size(), _cacheHelper != nullptr) {
 	_loader->parts(
@@ -1136,9 +1139,13 @@ void Reader::readFromCache(int sliceNumber) {
 	const auto key = _cacheHelper->key(sliceNumber);
 	const auto cache = std::weak_ptr<CacheHelper>(_cacheHelper);
 	const auto weak = base::make_weak(this);
+	const auto lookups = _cacheLookups;
 	const auto ready = [=](
 			QByteArray &&result,
 			std::vector<int> &&sizes = {}) {
+		if (lookups) {
+			lookups->registerBigFileLookup(!result.isEmpty());
+		}
 		crl::async([
 			=,
 			result = std::move(result),
@@ -1220,6 +1227,11 @@ Reader::FillState Reader::fill(
 	Expects(offset + buffer.size() <= size());
 	Expects(offset >= 0 && size() <= std::numeric_limits<uint32>::max());
 
+	if (const auto mapped = _loader->mapped(); !mapped.empty()) {
+		bytes::copy(buffer, mapped.subspan(offset, buffer.size()));
+		return FillState::Success;
+	}
+
 	const auto startWaiting = [&] {
 		if (_cacheHelper) {
 			_cacheHelper->waiting = notify.get();
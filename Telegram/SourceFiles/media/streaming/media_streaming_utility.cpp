@@ -11,6 +11,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/image/image_prepare.h"
 #include "ui/painter.h"
 #include "ffmpeg/ffmpeg_utility.h"
+#include "core/core_tracing.h"
 
 namespace Media {
 namespace Streaming {
@@ -136,6 +137,7 @@ QImage ConvertFrame(
 		not_null<AVFrame*> frame,
 		QSize resize,
 		QImage storage) {
+	const auto zone = Core::Tracing::Zone("Media::Streaming::ConvertFrame");
 	const auto frameSize = QSize(frame->width, frame->height);
 	if (frameSize.isEmpty()) {
 		LOG(("Streaming Error: Bad frame size %1,%2"
@@ -160,41 +162,35 @@ QImage ConvertFrame(
 	const auto hasDesiredFormat = (frame->format == format);
 	if (frameSize == storage.size() && hasDesiredFormat) {
 		static_assert(sizeof(uint32) == FFmpeg::kPixelBytesSize);
-		auto to = reinterpret_cast<uint32*>(storage.bits());
-		auto from = reinterpret_cast<const uint32*>(frame->data[0]);
-		const auto deltaTo = (storage.bytesPerLine() / sizeof(uint32))
-			- storage.width();
-		const auto deltaFrom = (frame->linesize[0] / sizeof(uint32))
-			- frame->width;
-		for ([[maybe_unused]] const auto y : ranges::views::ints(0, frame->height)) {
-			for ([[maybe_unused]] const auto x : ranges::views::ints(0, frame->width)) {
+		auto to = storage.bits();
+		auto from = static_cast<const uchar*>(frame->data[0]);
+		const auto perLineTo = storage.bytesPerLine();
+		const auto perLineFrom = frame->linesize[0];
+		const auto width = frame->width;
+		for (auto y = 0; y != frame->height; ++y) {
+			// Plain indexed loop, so that the compiler vectorizes it.
+			const auto lineTo = reinterpret_cast<uint32*>(to);
+			const auto lineFrom = reinterpret_cast<const uint32*>(from);
+			for (auto x = 0; x != width; ++x) {
 				// Wipe out possible alpha values.
-				*to++ = 0xFF000000U | *from++;
+				lineTo[x] = 0xFF000000U | lineFrom[x];
 			}
-			to += deltaTo;
-			from += deltaFrom;
+			to += perLineTo;
+			from += perLineFrom;
 		}
 	} else {
 		stream.swscale = MakeSwscalePointer(
 			frame,
 			resize,
-			&stream.swscale);
+			&stream.swscale,
+			true);
 		if (!stream.swscale) {
 			return QImage();
 		}
 
-		// AV_NUM_DATA_POINTERS defined in AVFrame struct
-		uint8_t *data[AV_NUM_DATA_POINTERS] = { storage.bits(), nullptr };
-		int linesize[AV_NUM_DATA_POINTERS] = { int(storage.bytesPerLine()), 0 };
-
-		sws_scale(
-			stream.swscale.get(),
-			frame->data,
-			frame->linesize,
-			0,
-			frame->height,
-			data,
-			linesize);
+		if (!FFmpeg::SwscaleToImage(stream.swscale, frame, storage)) {
+			return QImage();
+		}
 
 		if (frame->format == AV_PIX_FMT_YUVA420P) {
 			FFmpeg::PremultiplyInplace(storage);
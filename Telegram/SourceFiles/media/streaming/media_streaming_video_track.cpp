@@ -20,6 +20,7 @@ namespace {
 constexpr auto kMaxFrameArea = 3840 * 2160; // usual 4K
 constexpr auto kDisplaySkipped = crl::time(-1);
 constexpr auto kFinishedPosition = std::numeric_limits<crl::time>::max();
+constexpr auto kLateFrameThreshold = crl::time(40);
 static_assert(kDisplaySkipped != kTimeUnknown);
 
 [[nodiscard]] QImage ConvertToARGB32(
@@ -320,6 +321,7 @@ auto VideoTrackObject::readEnoughFrames(crl::time trackTime)
 				|| !VideoTrack::IsStale(frame, trackTime)) {
 				return v::null;
 			}
+			_shared->countDroppedFrame();
 		}
 	}, [&](Shared::PrepareNextCheck delay) -> ReadEnoughState {
 		return delay;
@@ -827,6 +829,7 @@ auto VideoTrack::Shared::prepareState(
 		} else if (IsStale(frame, trackTime)) {
 			std::swap(*frame, *next);
 			next->displayed = kDisplaySkipped;
+			countDroppedFrame();
 			return next;
 		} else {
 			if (frame->position - trackTime + 1 <= 0) { // Debugging crash.
@@ -968,6 +971,10 @@ crl::time VideoTrack::Shared::markFrameDisplayed(crl::time now) {
 		Assert(frame->position != kTimeUnknown);
 		if (frame->displayed == kTimeUnknown) {
 			frame->displayed = now;
+			if (frame->display != kTimeUnknown
+				&& now - frame->display > kLateFrameThreshold) {
+				_lateFrames.fetch_add(1, std::memory_order_relaxed);
+			}
 		}
 		return frame->position;
 	};
@@ -1027,6 +1034,7 @@ bool VideoTrack::Shared::markFrameShown() {
 		_counter.store(
 			next,
 			std::memory_order_release);
+		_shownFrames.fetch_add(1, std::memory_order_relaxed);
 		return true;
 	};
 
@@ -1043,6 +1051,18 @@ bool VideoTrack::Shared::markFrameShown() {
 	Unexpected("Counter value in VideoTrack::Shared::markFrameShown.");
 }
 
+void VideoTrack::Shared::countDroppedFrame() {
+	_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+}
+
+FrameStatistics VideoTrack::Shared::statistics() const {
+	return {
+		.shown = _shownFrames.load(std::memory_order_relaxed),
+		.dropped = _droppedFrames.load(std::memory_order_relaxed),
+		.late = _lateFrames.load(std::memory_order_relaxed),
+	};
+}
+
 not_null<VideoTrack::Frame*> VideoTrack::Shared::frameForPaint() {
 	return frameForPaintWithIndex().frame;
 }
@@ -1092,6 +1112,10 @@ crl::time VideoTrack::streamDuration() const {
 	return _streamDuration;
 }
 
+FrameStatistics VideoTrack::frameStatistics() const {
+	return _shared->statistics();
+}
+
 void VideoTrack::process(std::vector<FFmpeg::Packet> &&packets) {
 	_wrapped.with([
 		packets = std::move(packets)
@@ -1279,6 +1303,23 @@ void VideoTrack::PrepareFrameByRequests(
 
 	const auto begin = frame->prepared.begin();
 	const auto end = frame->prepared.end();
+	const auto findSame = [&](auto i) {
+		auto j = begin;
+		for (; j != i; ++j) {
+			if (j->second.request == i->second.request) {
+				break;
+			}
+		}
+		return j;
+	};
+
+	// Release images shared between instances with the same request
+	// first, so that the storage of the first of them can be reused.
+	for (auto i = begin; i != end; ++i) {
+		if (findSame(i) != i) {
+			i->second.image = QImage();
+		}
+	}
 	for (auto i = begin; i != end; ++i) {
 		auto &prepared = i->second;
 		if (!GoodForRequest(
@@ -1286,14 +1327,10 @@ void VideoTrack::PrepareFrameByRequests(
 				frame->alpha,
 				rotation,
 				prepared.request)) {
-			auto j = begin;
-			for (; j != i; ++j) {
-				if (j->second.request == prepared.request) {
-					prepared.image = QImage();
-					break;
-				}
-			}
-			if (j == i) {
+			const auto j = findSame(i);
+			if (j != i) {
+				prepared.image = j->second.image;
+			} else {
 				prepared.image = PrepareByRequest(
 					frame->original,
 					frame->alpha,
@@ -1337,6 +1374,13 @@ rpl::producer<> VideoTrack::waitingForData() const {
 }
 
 VideoTrack::~VideoTrack() {
+	const auto statistics = _shared->statistics();
+	if (statistics.dropped || statistics.late) {
+		DEBUG_LOG(("Video Info: Frames shown %1, dropped %2, late %3."
+			).arg(statistics.shown
+			).arg(statistics.dropped
+			).arg(statistics.late));
+	}
 	_wrapped.with([shared = std::move(_shared)](Implementation &unwrapped) {
 		unwrapped.interrupt();
 	});
@@ -35,6 +35,7 @@ public:
 	[[nodiscard]] int streamIndex() const;
 	[[nodiscard]] AVRational streamTimeBase() const;
 	[[nodiscard]] crl::time streamDuration() const;
+	[[nodiscard]] FrameStatistics frameStatistics() const;
 
 	// Called from the same unspecified thread.
 	void process(std::vector<FFmpeg::Packet> &&packets);
@@ -129,6 +130,10 @@ private:
 			bool dropStaleFrames);
 		[[nodiscard]] bool firstPresentHappened() const;
 
+		// Thread-safe.
+		void countDroppedFrame();
+		[[nodiscard]] FrameStatistics statistics() const;
+
 		// Called from the main thread.
 		// Returns the position of the displayed frame.
 		[[nodiscard]] crl::time markFrameDisplayed(crl::time now);
@@ -153,6 +158,10 @@ private:
 		// (_counter % 2) == 0 crl::queue can read _delay.
 		crl::time _delay = kTimeUnknown;
 
+		std::atomic<int> _shownFrames = 0;
+		std::atomic<int> _droppedFrames = 0;
+		std::atomic<int> _lateFrames = 0;
+
 	};
 
 	static void PrepareFrameByRequests(
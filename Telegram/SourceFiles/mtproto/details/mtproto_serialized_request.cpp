@@ -12,6 +12,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace MTP::details {
 namespace {
 
+// Up to 6 ints of alignment and up to 15 * 4 ints of random padding.
+constexpr auto kMaxPaddingInts = 6 + (0x0F << 2);
+
 uint32 CountPaddingPrimesCount(
 		uint32 requestSize,
 		bool forAuthKeyInner) {
@@ -46,8 +49,9 @@ SerializedRequest SerializedRequest::Prepare(
 
 	const auto finalSize = std::max(size, reserveSize);
 
+	// Reserve the padding as well, so that addPadding() won't reallocate.
 	auto result = SerializedRequest(RequestConstructHider::Tag{});
-	result->reserve(kMessageBodyPosition + finalSize);
+	result->reserve(kMessageBodyPosition + finalSize + kMaxPaddingInts);
 	result->resize(kMessageBodyPosition);
 	result->back() = (size << 2);
 	result->lastSentTime = crl::now();
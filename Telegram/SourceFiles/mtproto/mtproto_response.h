@@ -9,6 +9,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "base/flat_set.h"
 
+#include <any>
+
 namespace MTP {
 
 class Error {
@@ -56,6 +58,10 @@ inline bool IsDefaultHandledError(const Error &error) {
 
 struct Response {
 	mtpBuffer reply;
+
+	// Typed result of the reply, if it was parsed on the session thread.
+	std::any parsed;
+
 	mtpMsgId outerMsgId = 0;
 	mtpRequestId requestId = 0;
 };
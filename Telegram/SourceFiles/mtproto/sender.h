@@ -45,11 +45,17 @@ class Sender {
 				auto onstack = std::move(handler);
 				sender->senderRequestHandled(response.requestId);
 
-				auto result = Result();
-				auto from = response.reply.constData();
-				if (!result.read(from, from + response.reply.size())) {
-					return false;
-				} else if (!onstack) {
+				// Use the result parsed on the session thread, if any.
+				const auto parsed = std::any_cast<Result>(&response.parsed);
+				auto read = Result();
+				if (!parsed) {
+					auto from = response.reply.constData();
+					if (!read.read(from, from + response.reply.size())) {
+						return false;
+					}
+				}
+				const auto &result = parsed ? *parsed : read;
+				if (!onstack) {
 					return true;
 				} else if constexpr (IsCallable<
 						Handler,
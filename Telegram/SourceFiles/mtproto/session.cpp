@@ -12,10 +12,17 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/mtproto_auth_key.h"
 #include "core/application.h"
 #include "core/core_settings.h"
+#include "core/core_tracing.h"
 #include "base/unixtime.h"
 
 namespace MTP {
 namespace details {
+namespace {
+
+// Log main thread time spent on received data once per that many bytes.
+constexpr auto kReceivedStatsBytes = int64(16 * 1024 * 1024);
+
+} // namespace
 
 SessionOptions::SessionOptions(
 	const QString &systemLangCode,
@@ -557,10 +564,14 @@ void Session::tryToReceive() {
 		if (messages.empty()) {
 			break;
 		}
+		const auto zone = Core::Tracing::Zone("MTP::Session::tryToReceive");
+		const auto started = crl::profile();
+		auto bytes = int64();
 		const auto guard = QPointer<Session>(this);
 		const auto instance = QPointer<Instance>(_instance);
 		const auto main = (_shiftedDcId == BareDcId(_shiftedDcId));
 		for (const auto &message : messages) {
+			bytes += message.reply.size() * int64(sizeof(mtpPrime));
 			if (message.requestId) {
 				instance->processCallback(message);
 			} else if (main) {
@@ -574,7 +585,23 @@ void Session::tryToReceive() {
 		if (!guard) {
 			break;
 		}
+		countReceived(bytes, crl::profile() - started);
+	}
+}
+
+void Session::countReceived(int64 bytes, crl::profile_time duration) {
+	_receivedBytes += bytes;
+	_receivedDuration += duration;
+	if (_receivedBytes < kReceivedStatsBytes) {
+		return;
 	}
+	const auto perMegabyte = _receivedDuration
+		* 1024 * 1024
+		/ _receivedBytes;
+	DEBUG_LOG(("MTP Info: main thread spent %1 mcs per received MB "
+		"in dc %2.").arg(perMegabyte).arg(_shiftedDcId));
+	Core::Tracing::Counter("MTP::main_mcs_per_received_mb", perMegabyte);
+	_receivedBytes = _receivedDuration = 0;
 }
 
 void Session::killConnection() {
@@ -188,6 +188,7 @@ private:
 	void watchDcOptionsChanges();
 
 	void killConnection();
+	void countReceived(int64 bytes, crl::profile_time duration);
 
 	[[nodiscard]] bool releaseGenericKeyCreationOnDone(
 		const AuthKeyPtr &temporaryKey,
@@ -204,6 +205,9 @@ private:
 	bool _killed = false;
 	bool _needToReceive = false;
 
+	int64 _receivedBytes = 0;
+	crl::profile_time _receivedDuration = 0;
+
 	AuthKeyPtr _dcKeyForCheck;
 	CreatingKeyType _myKeyCreation = CreatingKeyType();
 
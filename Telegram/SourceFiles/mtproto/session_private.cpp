@@ -15,6 +15,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/mtproto_response.h"
 #include "mtproto/mtproto_dc_options.h"
 #include "mtproto/connection_abstract.h"
+#include "core/core_tracing.h"
 #include "base/random.h"
 #include "base/qthelp_url.h"
 #include "base/openssl_help.h"
@@ -50,6 +51,9 @@ constexpr auto kRequestConfigTimeout = 8 * crl::time(1000);
 // Don't try to handle messages larger than this size.
 constexpr auto kMaxMessageLength = 16 * 1024 * 1024;
 
+// Don't keep the decrypted message buffer larger than this size.
+constexpr auto kMaxKeptDecryptedBuffer = 1024 * 1024;
+
 // How much time passed from send till we resend request or check its state.
 constexpr auto kCheckSentRequestTimeout = 10 * crl::time(1000);
 
@@ -136,8 +140,126 @@ void WrapInvokeAfter(
 	return different;
 }
 
+template <typename Result>
+[[nodiscard]] std::any PreparseAs(const mtpBuffer &reply) {
+	auto result = Result();
+	auto from = reply.constData();
+	if (!result.read(from, from + reply.size())) {
+		return {};
+	}
+	return result;
+}
+
+// Big results are parsed here, so that the main thread only applies them.
+[[nodiscard]] std::any PreparseResponse(const mtpBuffer &reply) {
+	if (reply.isEmpty()) {
+		return {};
+	}
+	switch (mtpTypeId(reply[0])) {
+	case mtpc_updates:
+	case mtpc_updatesCombined:
+		return PreparseAs<MTPUpdates>(reply);
+	case mtpc_updates_difference:
+	case mtpc_updates_differenceSlice:
+		return PreparseAs<MTPupdates_Difference>(reply);
+	case mtpc_updates_channelDifference:
+	case mtpc_updates_channelDifferenceTooLong:
+		return PreparseAs<MTPupdates_ChannelDifference>(reply);
+	case mtpc_messages_dialogs:
+	case mtpc_messages_dialogsSlice:
+		return PreparseAs<MTPmessages_Dialogs>(reply);
+	}
+	return {};
+}
+
 } // namespace
 
+// Keeps one zlib stream for the whole session and resets it for each
+// gzip_packed object instead of allocating the inflate state every time.
+class SessionPrivate::Inflater final {
+public:
+	Inflater();
+	~Inflater();
+
+	[[nodiscard]] mtpBuffer unpack(const QByteArray &packed);
+
+private:
+	z_stream _stream = {};
+	bool _initialized = false;
+	bool _used = false;
+
+};
+
+SessionPrivate::Inflater::Inflater() {
+	const auto res = inflateInit2(&_stream, 16 + MAX_WBITS);
+	if (res != Z_OK) {
+		LOG(("RPC Error: could not init zlib stream, code: %1").arg(res));
+		return;
+	}
+	_initialized = true;
+}
+
+SessionPrivate::Inflater::~Inflater() {
+	if (_initialized) {
+		inflateEnd(&_stream);
+	}
+}
+
+mtpBuffer SessionPrivate::Inflater::unpack(const QByteArray &packed) {
+	if (!_initialized) {
+		return mtpBuffer();
+	} else if (_used) {
+		const auto res = inflateReset(&_stream);
+		if (res != Z_OK) {
+			LOG(("RPC Error: could not reset zlib stream, code: %1"
+				).arg(res));
+			return mtpBuffer();
+		}
+	}
+	_used = true;
+
+	const auto packedLen = uint32(packed.size());
+	_stream.avail_in = packedLen;
+	_stream.next_in = reinterpret_cast<Bytef*>(
+		const_cast<char*>(packed.constData()));
+
+	// Start from four times the packed size and grow geometrically,
+	// so that big well-compressed responses are not copied many times.
+	auto result = mtpBuffer(std::max(int(packedLen), 1));
+	auto filled = 0;
+	while (true) {
+		_stream.avail_out = (result.size() - filled) * sizeof(mtpPrime);
+		_stream.next_out = reinterpret_cast<Bytef*>(result.data() + filled);
+		const auto res = inflate(&_stream, Z_NO_FLUSH);
+		if (res != Z_OK && res != Z_STREAM_END) {
+			LOG(("RPC Error: could not unpack gziped data, code: %1"
+				).arg(res));
+			DEBUG_LOG(("RPC Error: bad gzip: %1"
+				).arg(Logs::mb(packed.constData(), packedLen).str()));
+			return mtpBuffer();
+		}
+		const auto written = int((result.size() - filled) * sizeof(mtpPrime)
+			- _stream.avail_out);
+		if (written & 0x03) {
+			const auto badSize = filled * int(sizeof(mtpPrime)) + written;
+			LOG(("RPC Error: bad length of unpacked data %1").arg(badSize));
+			DEBUG_LOG(("RPC Error: bad unpacked data %1"
+				).arg(Logs::mb(result.data(), badSize).str()));
+			return mtpBuffer();
+		}
+		filled += written / int(sizeof(mtpPrime));
+		if (res == Z_STREAM_END || _stream.avail_out) {
+			break;
+		}
+		result.resize(result.size() * 2);
+	}
+	result.resize(filled);
+	if (result.empty()) {
+		LOG(("RPC Error: bad length of unpacked data 0"));
+	}
+	return result;
+}
+
 SessionPrivate::SessionPrivate(
 	not_null<Instance*> instance,
 	not_null<QThread*> thread,
@@ -559,6 +681,7 @@ MTPVector<MTPJSONObjectValue> SessionPrivate::prepareInitParams() {
 }
 
 void SessionPrivate::tryToSend() {
+	const auto zone = Core::Tracing::Zone("MTP::SessionPrivate::tryToSend");
 	DEBUG_LOG(("MTP Info: tryToSend for dc %1.").arg(_shiftedDcId));
 	if (!_connection) {
 		DEBUG_LOG(("MTP Info: not yet connected in dc %1.").arg(_shiftedDcId));
@@ -1236,8 +1359,19 @@ void SessionPrivate::requestCDNConfig() {
 void SessionPrivate::handleReceived() {
 	Expects(_encryptionKey != nullptr);
 
+	const auto zone = Core::Tracing::Zone(
+		"MTP::SessionPrivate::handleReceived");
+	Core::Tracing::Counter(
+		"MTP::received_queue",
+		int64(_connection->received().size()));
+
 	onReceivedSome();
 
+	const auto releaseLarge = gsl::finally([&] {
+		if (_decryptedBuffer.capacity() > kMaxKeptDecryptedBuffer) {
+			_decryptedBuffer = bytes::vector();
+		}
+	});
 	while (!_connection->received().empty()) {
 		auto intsBuffer = std::move(_connection->received().front());
 		_connection->received().pop_front();
@@ -1263,12 +1397,13 @@ void SessionPrivate::handleReceived() {
 		auto encryptedInts = ints + kExternalHeaderIntsCount;
 		auto encryptedIntsCount = (intsCount - kExternalHeaderIntsCount) & ~0x03U;
 		auto encryptedBytesCount = encryptedIntsCount * kIntSize;
-		auto decryptedBuffer = QByteArray(encryptedBytesCount, Qt::Uninitialized);
 		auto msgKey = *(MTPint128*)(ints + 2);
 
-		aesIgeDecrypt(encryptedInts, decryptedBuffer.data(), encryptedBytesCount, _encryptionKey, msgKey);
+		// Reuse the buffer between received packets, unless it is large.
+		_decryptedBuffer.resize(encryptedBytesCount);
+		aesIgeDecrypt(encryptedInts, _decryptedBuffer.data(), encryptedBytesCount, _encryptionKey, msgKey);
 
-		auto decryptedInts = reinterpret_cast<const mtpPrime*>(decryptedBuffer.constData());
+		auto decryptedInts = reinterpret_cast<const mtpPrime*>(_decryptedBuffer.data());
 		auto serverSalt = *(uint64*)&decryptedInts[0];
 		auto session = *(uint64*)&decryptedInts[2];
 		auto msgId = *(uint64*)&decryptedInts[4];
@@ -1824,10 +1959,13 @@ SessionPrivate::HandleResult SessionPrivate::handleOneReceived(
 		}
 		const auto requestId = wasSent(requestMsgId);
 		if (requestId && requestId != mtpRequestId(0xFFFFFFFF)) {
+			auto parsed = PreparseResponse(response);
+
 			// Save rpc_result for processing in the main thread.
 			QWriteLocker locker(_sessionData->haveReceivedMutex());
 			_sessionData->haveReceivedMessages().push_back({
 				.reply = std::move(response),
+				.parsed = std::move(parsed),
 				.outerMsgId = info.outerMsgId,
 				.requestId = requestId,
 			});
@@ -1926,11 +2064,13 @@ SessionPrivate::HandleResult SessionPrivate::handleOneReceived(
 		if (end > from) {
 			memcpy(update.data(), from, (end - from) * sizeof(mtpPrime));
 		}
+		auto parsed = PreparseResponse(update);
 
 		// Notify main process about the new updates.
 		QWriteLocker locker(_sessionData->haveReceivedMutex());
 		_sessionData->haveReceivedMessages().push_back({
 			.reply = update,
+			.parsed = std::move(parsed),
 			.outerMsgId = info.outerMsgId,
 		});
 	} else {
@@ -1971,56 +2111,16 @@ SessionPrivate::HandleResult SessionPrivate::handleBindResponse(
 	Unexpected("Result of BoundKeyCreator::handleBindResponse.");
 }
 
-mtpBuffer SessionPrivate::ungzip(const mtpPrime *from, const mtpPrime *end) const {
-	mtpBuffer result; // * 4 because of mtpPrime type
-	result.resize(0);
-
+mtpBuffer SessionPrivate::ungzip(const mtpPrime *from, const mtpPrime *end) {
 	MTPstring packed;
 	if (!packed.read(from, end)) { // read packed string as serialized mtp string type
 		LOG(("RPC Error: could not read gziped bytes."));
-		return result;
-	}
-	uint32 packedLen = packed.v.size(), unpackedChunk = packedLen;
-
-	z_stream stream;
-	stream.zalloc = 0;
-	stream.zfree = 0;
-	stream.opaque = 0;
-	stream.avail_in = 0;
-	stream.next_in = 0;
-	int res = inflateInit2(&stream, 16 + MAX_WBITS);
-	if (res != Z_OK) {
-		LOG(("RPC Error: could not init zlib stream, code: %1").arg(res));
-		return result;
-	}
-	stream.avail_in = packedLen;
-	stream.next_in = reinterpret_cast<Bytef*>(packed.v.data());
-
-	stream.avail_out = 0;
-	while (!stream.avail_out) {
-		result.resize(result.size() + unpackedChunk);
-		stream.avail_out = unpackedChunk * sizeof(mtpPrime);
-		stream.next_out = (Bytef*)&result[result.size() - unpackedChunk];
-		int res = inflate(&stream, Z_NO_FLUSH);
-		if (res != Z_OK && res != Z_STREAM_END) {
-			inflateEnd(&stream);
-			LOG(("RPC Error: could not unpack gziped data, code: %1").arg(res));
-			DEBUG_LOG(("RPC Error: bad gzip: %1").arg(Logs::mb(packed.v.constData(), packedLen).str()));
-			return mtpBuffer();
-		}
-	}
-	if (stream.avail_out & 0x03) {
-		uint32 badSize = result.size() * sizeof(mtpPrime) - stream.avail_out;
-		LOG(("RPC Error: bad length of unpacked data %1").arg(badSize));
-		DEBUG_LOG(("RPC Error: bad unpacked data %1").arg(Logs::mb(result.data(), badSize).str()));
 		return mtpBuffer();
 	}
-	result.resize(result.size() - (stream.avail_out >> 2));
-	inflateEnd(&stream);
-	if (!result.size()) {
-		LOG(("RPC Error: bad length of unpacked data 0"));
+	if (!_inflater) {
+		_inflater = std::make_unique<Inflater>();
 	}
-	return result;
+	return _inflater->unpack(packed.v);
 }
 
 bool SessionPrivate::requestsFixTimeSalt(const QVector<MTPlong> &ids, const OuterInfo &info) {
@@ -53,6 +53,8 @@ public:
 private:
 	static constexpr auto kUpdateStateAlways = 666;
 
+	class Inflater;
+
 	struct TestConnection {
 		ConnectionPointer data;
 		int priority = 0;
@@ -133,7 +135,7 @@ private:
 	[[nodiscard]] HandleResult handleBindResponse(
 		mtpMsgId requestMsgId,
 		const mtpBuffer &response);
-	mtpBuffer ungzip(const mtpPrime *from, const mtpPrime *end) const;
+	[[nodiscard]] mtpBuffer ungzip(const mtpPrime *from, const mtpPrime *end);
 	void handleMsgsStates(const QVector<MTPlong> &ids, const QByteArray &states);
 
 	// _sessionDataMutex must be locked for read.
@@ -222,6 +224,8 @@ private:
 	uint64 _keyId = 0;
 	uint64 _sessionId = 0;
 	uint64 _sessionSalt = 0;
+	std::unique_ptr<Inflater> _inflater;
+	bytes::vector _decryptedBuffer;
 	uint32 _messagesCounter = 0;
 	bool _sessionMarkedAsStarted = false;
 
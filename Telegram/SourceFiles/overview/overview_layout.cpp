@@ -449,6 +449,10 @@ void Photo::clearSpoiler() {
 	}
 }
 
+void Photo::preload() const {
+	ensureDataMediaCreated();
+}
+
 void Photo::clearHeavyPart() {
 	_dataMedia = nullptr;
 }
@@ -618,6 +622,10 @@ void Video::clearSpoiler() {
 	}
 }
 
+void Video::preload() const {
+	ensureDataMediaCreated();
+}
+
 void Video::clearHeavyPart() {
 	_dataMedia = nullptr;
 }
@@ -2195,6 +2203,10 @@ void Gif::ensureDataMediaCreated() const {
 	delegate()->registerHeavyItem(this);
 }
 
+void Gif::preload() const {
+	ensureDataMediaCreated();
+}
+
 void Gif::clearHeavyPart() {
 	_gif.reset();
 	_dataMedia = nullptr;
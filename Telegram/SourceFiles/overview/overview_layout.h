@@ -74,6 +74,10 @@ public:
 	virtual void clearHeavyPart() {
 	}
 
+	// Start loading thumbnails before the item becomes visible.
+	virtual void preload() const {
+	}
+
 protected:
 	[[nodiscard]] not_null<HistoryItem*> parent() const {
 		return _parent;
@@ -205,6 +209,7 @@ public:
 		StateRequest request) const override;
 
 	void clearHeavyPart() override;
+	void preload() const override;
 
 private:
 	void ensureDataMediaCreated() const;
@@ -242,6 +247,7 @@ public:
 		StateRequest request) const override;
 
 	void clearHeavyPart() override;
+	void preload() const override;
 	void setPosition(int32 position) override;
 
 protected:
@@ -297,6 +303,7 @@ public:
 		StateRequest request) const override;
 
 	void clearHeavyPart() override;
+	void preload() const override;
 	void clearSpoiler() override;
 
 protected:
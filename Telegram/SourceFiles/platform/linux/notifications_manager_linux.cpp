@@ -41,9 +41,17 @@ constexpr auto kService = "org.freedesktop.Notifications";
 constexpr auto kObjectPath = "/org/freedesktop/Notifications";
 constexpr auto kInterface = kService;
 constexpr auto kPropertiesInterface = "org.freedesktop.DBus.Properties";
+constexpr auto kMaxNotifyRequests = 4;
+constexpr auto kMaxQueuedNotifications = 32;
+constexpr auto kImagesCacheLimit = 64;
 
 using PropertyMap = std::map<Glib::ustring, Glib::VariantBase>;
 
+struct NotificationImage {
+	Glib::RefPtr<Gio::Icon> icon;
+	Glib::VariantBase hint;
+};
+
 struct ServerInformation {
 	Glib::ustring name;
 	Glib::ustring vendor;
@@ -346,9 +354,14 @@ public:
 
 	~NotificationData();
 
-	void show();
+	[[nodiscard]] NotificationId id() const;
+
+	// Calls done() when the request is finished, even if it failed.
+	void show(Fn<void()> done);
 	void close();
-	void setImage(QImage image);
+
+	[[nodiscard]] NotificationImage prepareImage(QImage image) const;
+	void setImage(const NotificationImage &image);
 
 private:
 	const not_null<Manager*> _manager;
@@ -618,15 +631,24 @@ NotificationData::~NotificationData() {
 	}
 }
 
-void NotificationData::show() {
+NotificationData::NotificationId NotificationData::id() const {
+	return _id;
+}
+
+void NotificationData::show(Fn<void()> done) {
 	if (_application && _notification) {
 		_application->send_notification(_guid, _notification);
+		done();
 		return;
 	}
 
 	// a hack for snap's activation restriction
 	const auto weak = base::make_weak(this);
-	StartServiceAsync(crl::guard(weak, [=] {
+	StartServiceAsync([=] {
+		if (!weak) {
+			done();
+			return;
+		}
 		const auto iconName = _imageKey.empty()
 			|| _hints.find(_imageKey) == end(_hints)
 				? Glib::ustring(base::IconName().toStdString())
@@ -647,20 +669,22 @@ void NotificationData::show() {
 				_hints,
 				-1,
 			}),
-			crl::guard(weak, [=](
-					const Glib::RefPtr<Gio::AsyncResult> &result) {
+			[=](const Glib::RefPtr<Gio::AsyncResult> &result) {
 				Core::Sandbox::Instance().customEnterFromEventLoop([&] {
-					Noexcept([&] {
-						_notificationId = connection->call_finish(result)
-							.get_child(0)
-							.get_dynamic<uint>();
-					}, [&] {
-						_manager->clearNotification(_id);
-					});
+					if (weak) {
+						Noexcept([&] {
+							_notificationId = connection->call_finish(result)
+								.get_child(0)
+								.get_dynamic<uint>();
+						}, [&] {
+							_manager->clearNotification(_id);
+						});
+					}
+					done();
 				});
-			}),
+			},
 			kService);
-	}));
+	});
 }
 
 void NotificationData::close() {
@@ -684,7 +708,7 @@ void NotificationData::close() {
 	_manager->clearNotification(_id);
 }
 
-void NotificationData::setImage(QImage image) {
+NotificationImage NotificationData::prepareImage(QImage image) const {
 	if (_notification) {
 		const auto imageData = [&] {
 			QByteArray ba;
@@ -694,17 +718,16 @@ void NotificationData::setImage(QImage image) {
 			return ba;
 		}();
 
-		_notification->set_icon(
-			Gio::BytesIcon::create(
+		return {
+			.icon = Gio::BytesIcon::create(
 				Glib::Bytes::create(
 					imageData.constData(),
-					imageData.size())));
-
-		return;
+					imageData.size())),
+		};
 	}
 
 	if (_imageKey.empty()) {
-		return;
+		return {};
 	}
 
 	if (image.hasAlphaChannel()) {
@@ -713,17 +736,29 @@ void NotificationData::setImage(QImage image) {
 		image.convertTo(QImage::Format_RGB888);
 	}
 
-	_hints[_imageKey] = Glib::create_variant(std::tuple{
-		image.width(),
-		image.height(),
-		int(image.bytesPerLine()),
-		image.hasAlphaChannel(),
-		8,
-		image.hasAlphaChannel() ? 4 : 3,
-		std::vector<uchar>(
-			image.constBits(),
-			image.constBits() + image.sizeInBytes()),
-	});
+	return {
+		.hint = Glib::create_variant(std::tuple{
+			image.width(),
+			image.height(),
+			int(image.bytesPerLine()),
+			image.hasAlphaChannel(),
+			8,
+			image.hasAlphaChannel() ? 4 : 3,
+			std::vector<uchar>(
+				image.constBits(),
+				image.constBits() + image.sizeInBytes()),
+		}),
+	};
+}
+
+void NotificationData::setImage(const NotificationImage &image) {
+	if (_notification) {
+		if (image.icon) {
+			_notification->set_icon(image.icon);
+		}
+	} else if (!_imageKey.empty() && image.hint) {
+		_hints[_imageKey] = image.hint;
+	}
 }
 
 void NotificationData::notificationClosed(uint id, uint reason) {
@@ -903,12 +938,28 @@ public:
 	~Private();
 
 private:
+	using ImageKey = std::tuple<uint64, PeerId, InMemoryKey>;
+
+	[[nodiscard]] const NotificationImage &lookupImage(
+		not_null<PeerData*> peer,
+		Ui::PeerUserpicView &userpicView,
+		not_null<NotificationData*> notification);
+	void enqueueShow(not_null<NotificationData*> notification);
+	void showQueued();
+
 	const not_null<Manager*> _manager;
 
 	base::flat_map<
 		ContextId,
 		base::flat_map<MsgId, Notification>> _notifications;
 
+	// Converted userpics, so that bursts don't regenerate them.
+	base::flat_map<ImageKey, NotificationImage> _images;
+
+	// Notify calls are limited, the rest wait here, the oldest are dropped.
+	std::deque<base::weak_ptr<NotificationData>> _showQueue;
+	int _showRequests = 0;
+
 	Glib::RefPtr<Gio::DBus::Connection> _dbusConnection;
 	bool _inhibited = false;
 	uint _inhibitedSignalId = 0;
@@ -1029,7 +1080,7 @@ void Manager::Private::showNotification(
 
 	if (!options.hideNameAndPhoto) {
 		notification->setImage(
-			Window::Notifications::GenerateUserpic(peer, userpicView));
+			lookupImage(peer, userpicView, notification.get()));
 	}
 
 	auto i = _notifications.find(key);
@@ -1050,7 +1101,58 @@ void Manager::Private::showNotification(
 	const auto j = i->second.emplace(
 		msgId,
 		std::move(notification)).first;
-	j->second->show();
+	enqueueShow(j->second.get());
+}
+
+const NotificationImage &Manager::Private::lookupImage(
+		not_null<PeerData*> peer,
+		Ui::PeerUserpicView &userpicView,
+		not_null<NotificationData*> notification) {
+	const auto key = ImageKey{
+		peer->session().uniqueId(),
+		peer->id,
+		peer->userpicUniqueKey(userpicView),
+	};
+	auto i = _images.find(key);
+	if (i == end(_images)) {
+		if (_images.size() >= kImagesCacheLimit) {
+			_images.clear();
+		}
+		i = _images.emplace(
+			key,
+			notification->prepareImage(
+				Window::Notifications::GenerateUserpic(peer, userpicView))
+		).first;
+	}
+	return i->second;
+}
+
+void Manager::Private::enqueueShow(
+		not_null<NotificationData*> notification) {
+	_showQueue.push_back(base::make_weak(notification));
+	while (_showQueue.size() > kMaxQueuedNotifications) {
+		const auto dropped = _showQueue.front().get();
+		_showQueue.pop_front();
+		if (dropped) {
+			clearNotification(dropped->id());
+		}
+	}
+	showQueued();
+}
+
+void Manager::Private::showQueued() {
+	while (_showRequests < kMaxNotifyRequests && !_showQueue.empty()) {
+		const auto notification = _showQueue.front().get();
+		_showQueue.pop_front();
+		if (!notification) {
+			continue;
+		}
+		++_showRequests;
+		notification->show(crl::guard(this, [=] {
+			--_showRequests;
+			showQueued();
+		}));
+	}
 }
 
 void Manager::Private::clearAll() {
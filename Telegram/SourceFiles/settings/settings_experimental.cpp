@@ -17,6 +17,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/options.h"
 #include "core/application.h"
 #include "core/launcher.h"
+#include "core/core_tracing.h"
+#include "core/stall_detector.h"
 #include "chat_helpers/tabbed_panel.h"
 #include "dialogs/dialogs_widget.h"
 #include "info/profile/info_profile_values.h"
@@ -150,7 +152,10 @@ void SetupExperimental(
 	addToggle(Webview::kOptionWebviewDebugEnabled);
 	addToggle(kOptionAutoScrollInactiveChat);
 	addToggle(Window::Notifications::kOptionGNotification);
+	addToggle(Window::Notifications::kOptionNotificationsDigest);
 	addToggle(Core::kOptionFreeType);
+	addToggle(Core::Tracing::kOptionHotPathTracing);
+	addToggle(Core::StallDetector::kOptionStallWatchdog);
 	addToggle(Data::kOptionExternalVideoPlayer);
 }
 
@@ -232,6 +232,26 @@ bool ReadSetting(
 		context.cacheBigFileTotalTimeLimit = NoTimeLimit(timeBig) ? 0 : timeBig;
 	} break;
 
+	case dbiCacheTagQuotas: {
+		qint32 count;
+		stream >> count;
+		if (!CheckStreamStatus(stream) || count < 0 || count > 0xFF) {
+			return false;
+		}
+		auto quotas = CacheTagQuotas();
+		for (auto i = 0; i != count; ++i) {
+			qint32 tag;
+			qint64 quota;
+			stream >> tag >> quota;
+			if (!CheckStreamStatus(stream)) {
+				return false;
+			} else if (tag > 0 && tag <= 0xFF && quota > 0) {
+				quotas.emplace(uint8(tag), quota);
+			}
+		}
+		context.cacheTagQuotas = std::move(quotas);
+	} break;
+
 	case dbiPowerSaving: {
 		qint32 settings;
 		stream >> settings;
@@ -45,6 +45,7 @@ struct ReadSettingsContext {
 	qint32 cacheTotalTimeLimit = 0;
 	qint64 cacheBigFileTotalSizeLimit = 0;
 	qint32 cacheBigFileTotalTimeLimit = 0;
+	CacheTagQuotas cacheTagQuotas;
 
 	std::unique_ptr<Main::SessionSettings> sessionSettingsStorage;
 
@@ -165,6 +166,7 @@ enum {
 	dbiDialogsFiltersOld = 0x5f,
 	dbiFallbackProductionConfig = 0x60,
 	dbiBackgroundKey = 0x61,
+	dbiCacheTagQuotas = 0x62,
 
 	dbiEncryptedWithSalt = 333,
 	dbiEncrypted = 444,
@@ -14,6 +14,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_session.h"
 #include "data/data_document.h"
 #include "apiwrap.h"
+#include "core/core_tracing.h"
 #include "base/openssl_help.h"
 
 namespace Storage {
@@ -169,6 +170,8 @@ void DownloadManagerMtproto::checkSendNext() {
 }
 
 void DownloadManagerMtproto::checkSendNext(MTP::DcId dcId, Queue &queue) {
+	const auto zone = Core::Tracing::Zone(
+		"Storage::DownloadManagerMtproto::checkSendNext");
 	while (trySendNextPart(dcId, queue)) {
 	}
 }
@@ -233,6 +236,10 @@ void DownloadManagerMtproto::requestSucceeded(
 		crl::time timeAtRequestStart) {
 	using namespace rpl::mappers;
 
+	Core::Tracing::Counter(
+		"Storage::DownloadManagerMtproto::latency",
+		crl::now() - timeAtRequestStart);
+
 	const auto i = _balanceData.find(dcId);
 	Assert(i != end(_balanceData));
 	auto &dc = i->second;
@@ -15,6 +15,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/application.h"
 #include "core/file_location.h"
 #include "storage/storage_account.h"
+#include "storage/storage_cache_lookups.h"
+#include "storage/storage_cache_quotas.h"
 #include "storage/file_download_mtproto.h"
 #include "storage/file_download_web.h"
 #include "platform/platform_file_utilities.h"
@@ -211,6 +213,7 @@ void FileLoader::localLoaded(
 		const QImage &imageData) {
 	_localLoading = nullptr;
 	if (result.data.isEmpty()) {
+		_session->data().cacheLookups()->registerLookup(_cacheTag, false);
 		_localStatus = LocalStatus::NotFound;
 		start();
 		return;
@@ -218,12 +221,15 @@ void FileLoader::localLoaded(
 	const auto partial = result.data.startsWith("partial:");
 	constexpr auto kPrefix = 8;
 	if (partial	&& result.data.size() < _loadSize + kPrefix) {
+		_session->data().cacheLookups()->registerLookup(_cacheTag, false);
 		_localStatus = LocalStatus::NotFound;
 		if (checkForOpen()) {
 			startLoadingWithPartial(result.data);
 		}
 		return;
 	}
+	_session->data().cacheLookups()->registerLookup(_cacheTag, true);
+	_session->data().cacheQuotas().registerUse(cacheKey());
 	if (!imageData.isNull()) {
 		_imageFormat = imageFormat;
 		_imageData = imageData;
@@ -458,12 +464,17 @@ bool FileLoader::finalizeResult() {
 		if ((_toCache == LoadToCacheAsWell)
 			&& (_data.size() <= Storage::kMaxFileInMemory)
 			&& (key.low || key.high)) {
+			auto value = (!_fullSize || _data.size() == _fullSize)
+				? base::duplicate(_data)
+				: ("partial:" + _data);
+			_session->data().cacheQuotas().registerPut(
+				key,
+				_cacheTag,
+				value.size());
 			_session->data().cache().put(
-				cacheKey(),
+				key,
 				Storage::Cache::Database::TaggedValue(
-					base::duplicate((!_fullSize || _data.size() == _fullSize)
-						? _data
-						: ("partial:" + _data)),
+					std::move(value),
 					_cacheTag));
 		}
 	}
@@ -856,12 +856,24 @@ void Account::writeSessionSettings(Main::SessionSettings *stored) {
 	size += sizeof(quint32) + 3 * sizeof(qint32);
 	size += sizeof(quint32) + 2 * sizeof(qint32);
 	size += sizeof(quint32) + sizeof(qint64) + sizeof(qint32);
+	if (!_cacheTagQuotas.empty()) {
+		size += sizeof(quint32) + sizeof(qint32)
+			+ _cacheTagQuotas.size() * (sizeof(qint32) + sizeof(qint64));
+	}
 	if (!userData.isEmpty()) {
 		size += sizeof(quint32) + Serialize::bytearraySize(userData);
 	}
 
 	EncryptedDescriptor data(size);
 	data.stream << quint32(dbiCacheSettings) << qint64(_cacheTotalSizeLimit) << qint32(_cacheTotalTimeLimit) << qint64(_cacheBigFileTotalSizeLimit) << qint32(_cacheBigFileTotalTimeLimit);
+	if (!_cacheTagQuotas.empty()) {
+		data.stream
+			<< quint32(dbiCacheTagQuotas)
+			<< qint32(_cacheTagQuotas.size());
+		for (const auto &[tag, quota] : _cacheTagQuotas) {
+			data.stream << qint32(tag) << qint64(quota);
+		}
+	}
 	if (!userData.isEmpty()) {
 		data.stream << quint32(dbiSessionSettings) << userData;
 	}
@@ -932,6 +944,7 @@ std::unique_ptr<Main::SessionSettings> Account::applyReadContext(
 		Assert(_cacheTotalSizeLimit > normal.maxDataSize);
 		Assert(_cacheBigFileTotalSizeLimit > normal.maxDataSize);
 	}
+	_cacheTagQuotas = std::move(context.cacheTagQuotas);
 
 	if (!context.mtpAuthorization.isEmpty()) {
 		_owner->setMtpAuthorization(context.mtpAuthorization);
@@ -1668,6 +1681,18 @@ Cache::Database::Settings Account::cacheBigFileSettings() const {
 	return result;
 }
 
+const CacheTagQuotas &Account::cacheTagQuotas() const {
+	return _cacheTagQuotas;
+}
+
+void Account::updateCacheTagQuotas(CacheTagQuotas quotas) {
+	if (_cacheTagQuotas == quotas) {
+		return;
+	}
+	_cacheTagQuotas = std::move(quotas);
+	writeSessionSettings();
+}
+
 void Account::writeStickerSet(
 		QDataStream &stream,
 		const Data::StickersSet &set) {
@@ -10,6 +10,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/timer.h"
 #include "base/flags.h"
 #include "storage/cache/storage_cache_database.h"
+#include "storage/storage_cache_quotas.h"
 #include "data/stickers/data_stickers_set.h"
 #include "data/data_drafts.h"
 
@@ -117,6 +118,9 @@ public:
 	[[nodiscard]] QString cacheBigFilePath() const;
 	[[nodiscard]] Cache::Database::Settings cacheBigFileSettings() const;
 
+	[[nodiscard]] const CacheTagQuotas &cacheTagQuotas() const;
+	void updateCacheTagQuotas(CacheTagQuotas quotas);
+
 	void writeInstalledStickers();
 	void writeFeaturedStickers();
 	void writeRecentStickers();
@@ -296,6 +300,7 @@ private:
 	qint64 _cacheBigFileTotalSizeLimit = 0;
 	qint32 _cacheTotalTimeLimit = 0;
 	qint32 _cacheBigFileTotalTimeLimit = 0;
+	CacheTagQuotas _cacheTagQuotas;
 
 	base::flat_map<PeerId, base::flags<BotTrustFlag>> _trustedBots;
 	bool _trustedBotsRead = false;
@@ -0,0 +1,51 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "storage/storage_cache_lookups.h"
+
+namespace Storage {
+
+void CacheLookups::Counter::add(bool hit) {
+	(hit ? hits : misses).fetch_add(1, std::memory_order_relaxed);
+}
+
+auto CacheLookups::Counter::load() const -> Counts {
+	return {
+		.hits = hits.load(std::memory_order_relaxed),
+		.misses = misses.load(std::memory_order_relaxed),
+	};
+}
+
+void CacheLookups::registerLookup(uint8 tag, bool hit) {
+	_tagged[tag].add(hit);
+}
+
+void CacheLookups::registerBigFileLookup(bool hit) {
+	_bigFile.add(hit);
+}
+
+auto CacheLookups::counts(uint8 tag) const -> Counts {
+	return _tagged[tag].load();
+}
+
+auto CacheLookups::bigFileCounts() const -> Counts {
+	return _bigFile.load();
+}
+
+FnMut<void(QByteArray &&value)> CountBigFileLookup(
+		std::shared_ptr<CacheLookups> lookups,
+		FnMut<void(QByteArray &&value)> done) {
+	return [
+		lookups = std::move(lookups),
+		done = std::move(done)
+	](QByteArray &&value) mutable {
+		lookups->registerBigFileLookup(!value.isEmpty());
+		done(std::move(value));
+	};
+}
+
+} // namespace Storage
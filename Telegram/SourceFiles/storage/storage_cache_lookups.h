@@ -0,0 +1,50 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include <array>
+#include <atomic>
+
+namespace Storage {
+
+// Hit / miss counters of local cache lookups for this app launch.
+// Lookup results arrive on the cache threads, so it is safe to register
+// them from any thread, callbacks should hold the shared pointer.
+class CacheLookups final {
+public:
+	struct Counts {
+		int hits = 0;
+		int misses = 0;
+	};
+
+	void registerLookup(uint8 tag, bool hit);
+	void registerBigFileLookup(bool hit);
+
+	[[nodiscard]] Counts counts(uint8 tag) const;
+	[[nodiscard]] Counts bigFileCounts() const;
+
+private:
+	struct Counter {
+		void add(bool hit);
+		[[nodiscard]] Counts load() const;
+
+		std::atomic<int> hits = 0;
+		std::atomic<int> misses = 0;
+	};
+
+	std::array<Counter, 256> _tagged;
+	Counter _bigFile;
+
+};
+
+// Counts a big file cache lookup as a hit if a value was found.
+[[nodiscard]] FnMut<void(QByteArray &&value)> CountBigFileLookup(
+	std::shared_ptr<CacheLookups> lookups,
+	FnMut<void(QByteArray &&value)> done);
+
+} // namespace Storage
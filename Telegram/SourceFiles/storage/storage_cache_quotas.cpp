@@ -0,0 +1,243 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "storage/storage_cache_quotas.h"
+
+#include "base/unixtime.h"
+
+namespace Storage {
+namespace {
+
+constexpr auto kIndexVersion = 1;
+constexpr auto kMaxIndexEntries = 16384;
+constexpr auto kSaveIndexDelay = 10 * crl::time(1000);
+constexpr auto kEnforceDelay = 5 * crl::time(1000);
+
+// Each use counts as six hours of recency, up to a week in total.
+constexpr auto kUseBonus = TimeId(6 * 60 * 60);
+constexpr auto kMaxCountedUses = 28;
+
+} // namespace
+
+CacheQuotas::CacheQuotas(
+	not_null<Cache::Database*> database,
+	Key indexKey,
+	CacheTagQuotas quotas)
+: _database(database)
+, _indexKey(indexKey)
+, _quotas(std::move(quotas))
+, _saveTimer([=] { saveIndex(); })
+, _enforceTimer([=] { enforce(); }) {
+	loadIndex();
+}
+
+CacheQuotas::~CacheQuotas() {
+	if (_saveTimer.isActive() && _indexLoaded) {
+		saveIndex();
+	}
+}
+
+void CacheQuotas::registerPut(const Key &key, uint8 tag, int64 size) {
+	auto &entry = _entries[key];
+	entry.tag = tag;
+	entry.size = int32(std::min(size, int64(INT_MAX)));
+	entry.lastUse = base::unixtime::now();
+	entry.uses = std::max(entry.uses, uint16(1));
+	indexChanged();
+	if (_quotas.contains(tag) && !_enforceTimer.isActive()) {
+		_enforceTimer.callOnce(kEnforceDelay);
+	}
+}
+
+void CacheQuotas::registerUse(const Key &key) {
+	const auto i = _entries.find(key);
+	if (i == end(_entries)) {
+		return;
+	}
+	i->second.lastUse = base::unixtime::now();
+	if (i->second.uses < std::numeric_limits<uint16>::max()) {
+		++i->second.uses;
+	}
+	indexChanged();
+}
+
+void CacheQuotas::setQuotas(CacheTagQuotas quotas) {
+	if (_quotas == quotas) {
+		return;
+	}
+	_quotas = std::move(quotas);
+	enforce();
+}
+
+void CacheQuotas::setPinned(base::flat_set<Key> keys) {
+	_pinned = std::move(keys);
+}
+
+void CacheQuotas::loadIndex() {
+	_database->get(_indexKey, [=](QByteArray &&value) {
+		crl::on_main(this, [=, value = std::move(value)] {
+			applyIndex(value);
+		});
+	});
+}
+
+void CacheQuotas::applyIndex(const QByteArray &serialized) {
+	_indexLoaded = true;
+	if (serialized.isEmpty()) {
+		return;
+	}
+	QDataStream stream(serialized);
+	stream.setVersion(QDataStream::Qt_5_1);
+
+	auto version = qint32();
+	auto count = qint32();
+	stream >> version >> count;
+	if (stream.status() != QDataStream::Ok
+		|| version != kIndexVersion
+		|| count < 0
+		|| count > kMaxIndexEntries) {
+		return;
+	}
+	for (auto i = 0; i != count; ++i) {
+		auto high = quint64();
+		auto low = quint64();
+		auto tag = qint32();
+		auto size = qint32();
+		auto lastUse = qint32();
+		auto uses = qint32();
+		stream >> high >> low >> tag >> size >> lastUse >> uses;
+		if (stream.status() != QDataStream::Ok) {
+			return;
+		}
+		// Entries registered before the index was read are more recent.
+		_entries.emplace(Key{ high, low }, Entry{
+			.tag = uint8(tag),
+			.size = size,
+			.lastUse = TimeId(lastUse),
+			.uses = uint16(std::clamp(uses, 0, 0xFFFF)),
+		});
+	}
+	trimIndex();
+	if (!_quotas.empty()) {
+		enforce();
+	}
+}
+
+QByteArray CacheQuotas::serializeIndex() const {
+	auto result = QByteArray();
+	result.reserve(2 * sizeof(qint32)
+		+ _entries.size() * (2 * sizeof(quint64) + 4 * sizeof(qint32)));
+	{
+		QDataStream stream(&result, QIODevice::WriteOnly);
+		stream.setVersion(QDataStream::Qt_5_1);
+		stream << qint32(kIndexVersion) << qint32(_entries.size());
+		for (const auto &[key, entry] : _entries) {
+			stream
+				<< quint64(key.high)
+				<< quint64(key.low)
+				<< qint32(entry.tag)
+				<< qint32(entry.size)
+				<< qint32(entry.lastUse)
+				<< qint32(entry.uses);
+		}
+	}
+	return result;
+}
+
+void CacheQuotas::indexChanged() {
+	if (!_saveTimer.isActive()) {
+		_saveTimer.callOnce(kSaveIndexDelay);
+	}
+}
+
+void CacheQuotas::saveIndex() {
+	_saveTimer.cancel();
+	if (!_indexLoaded) {
+		// Don't overwrite the stored index before it was merged.
+		_saveTimer.callOnce(kSaveIndexDelay);
+		return;
+	}
+	trimIndex();
+	_database->put(_indexKey, serializeIndex());
+}
+
+void CacheQuotas::trimIndex() {
+	const auto excess = int(_entries.size()) - kMaxIndexEntries;
+	if (excess <= 0) {
+		return;
+	}
+	// Forget about the least valuable entries, they stay in the cache
+	// and are still removed by its own size and time limits.
+	auto scores = std::vector<std::pair<TimeId, Key>>();
+	scores.reserve(_entries.size());
+	for (const auto &[key, entry] : _entries) {
+		scores.emplace_back(Score(entry), key);
+	}
+	ranges::nth_element(scores, begin(scores) + excess);
+	for (auto i = 0; i != excess; ++i) {
+		_entries.erase(scores[i].second);
+	}
+}
+
+void CacheQuotas::enforce() {
+	_enforceTimer.cancel();
+	if (_quotas.empty()) {
+		return;
+	}
+	_database->statsOnMain(
+	) | rpl::take(
+		1
+	) | rpl::start_with_next([=](Cache::Database::Stats &&stats) {
+		evict(stats);
+	}, _lifetime);
+}
+
+void CacheQuotas::evict(const Cache::Database::Stats &stats) {
+	for (const auto &[tag, quota] : _quotas) {
+		const auto i = stats.tagged.find(tag);
+		if (i != end(stats.tagged) && i->second.totalSize > quota) {
+			evict(tag, i->second.totalSize - quota);
+		}
+	}
+}
+
+void CacheQuotas::evict(uint8 tag, int64 excess) {
+	auto candidates = std::vector<std::pair<TimeId, Key>>();
+	for (const auto &[key, entry] : _entries) {
+		if (entry.tag == tag && !_pinned.contains(key)) {
+			candidates.emplace_back(Score(entry), key);
+		}
+	}
+	ranges::sort(candidates);
+
+	auto removed = int64();
+	for (const auto &[score, key] : candidates) {
+		if (removed >= excess) {
+			break;
+		}
+		const auto i = _entries.find(key);
+		removed += i->second.size;
+		_entries.erase(i);
+		_database->remove(key);
+	}
+	if (removed < excess) {
+		DEBUG_LOG(("Cache Quotas: Tag %1 is %2 bytes over quota "
+			"with no more known entries to remove."
+			).arg(tag
+			).arg(excess - removed));
+	}
+	if (removed > 0) {
+		indexChanged();
+	}
+}
+
+TimeId CacheQuotas::Score(const Entry &entry) {
+	const auto uses = std::min(int(entry.uses), kMaxCountedUses);
+	return entry.lastUse + uses * kUseBonus;
+}
+
+} // namespace Storage
@@ -0,0 +1,78 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "storage/cache/storage_cache_database.h"
+#include "base/timer.h"
+#include "base/weak_ptr.h"
+
+#include <map>
+
+namespace Storage {
+
+using CacheTagQuotas = base::flat_map<uint8, int64>;
+
+// Per-tag size quotas for the local cache, on top of its own total size
+// and time limits. Entries are remembered with their tag, size and usage.
+// When a tag goes over its quota the entries with the lowest score are
+// removed, where the score is the last use time raised by the use count,
+// so an often used entry outlives a recent one that was used only once.
+// Pinned keys (installed stickers) are never removed.
+class CacheQuotas final : public base::has_weak_ptr {
+public:
+	using Key = Cache::Key;
+
+	CacheQuotas(
+		not_null<Cache::Database*> database,
+		Key indexKey,
+		CacheTagQuotas quotas);
+	~CacheQuotas();
+
+	void registerPut(const Key &key, uint8 tag, int64 size);
+	void registerUse(const Key &key);
+
+	void setQuotas(CacheTagQuotas quotas);
+	void setPinned(base::flat_set<Key> keys);
+
+private:
+	struct Entry {
+		uint8 tag = 0;
+		int32 size = 0;
+		TimeId lastUse = 0;
+		uint16 uses = 0;
+	};
+
+	void loadIndex();
+	void applyIndex(const QByteArray &serialized);
+	[[nodiscard]] QByteArray serializeIndex() const;
+	void indexChanged();
+	void saveIndex();
+	void trimIndex();
+
+	void enforce();
+	void evict(const Cache::Database::Stats &stats);
+	void evict(uint8 tag, int64 excess);
+
+	[[nodiscard]] static TimeId Score(const Entry &entry);
+
+	const not_null<Cache::Database*> _database;
+	const Key _indexKey;
+
+	std::map<Key, Entry> _entries;
+	base::flat_set<Key> _pinned;
+	CacheTagQuotas _quotas;
+
+	base::Timer _saveTimer;
+	base::Timer _enforceTimer;
+	bool _indexLoaded = false;
+
+	rpl::lifetime _lifetime;
+
+};
+
+} // namespace Storage
@@ -15,7 +15,6 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/chat/attach/attach_prepare.h"
 #include "core/crash_reports.h"
 
-#include <QtCore/QSemaphore>
 #include <QtCore/QMimeData>
 
 namespace Storage {
@@ -54,23 +53,6 @@ QSize PrepareShownDimensions(const QImage &preview, int sideLimit) {
 		: result;
 }
 
-void PrepareDetailsInParallel(PreparedList &result, int previewWidth) {
-	Expects(result.files.size() <= Ui::MaxAlbumItems());
-
-	if (result.files.empty()) {
-		return;
-	}
-	const auto sideLimit = PhotoSideLimit(); // Get on main thread.
-	QSemaphore semaphore;
-	for (auto &file : result.files) {
-		crl::async([=, &semaphore, &file] {
-			PrepareDetails(file, previewWidth, sideLimit);
-			semaphore.release();
-		});
-	}
-	semaphore.acquire(result.files.size());
-}
-
 } // namespace
 
 bool ValidatePhotoEditorMediaDragData(not_null<const QMimeData*> data) {
@@ -168,6 +150,21 @@ PreparedList PrepareMediaList(
 		const QList<QUrl> &files,
 		int previewWidth,
 		bool premium) {
+	auto result = CollectMediaList(files, premium);
+	PrepareFirstFile(result, previewWidth);
+	return result;
+}
+
+PreparedList PrepareMediaList(
+		const QStringList &files,
+		int previewWidth,
+		bool premium) {
+	auto result = CollectMediaList(files, premium);
+	PrepareFirstFile(result, previewWidth);
+	return result;
+}
+
+PreparedList CollectMediaList(const QList<QUrl> &files, bool premium) {
 	auto locals = QStringList();
 	locals.reserve(files.size());
 	for (const auto &url : files) {
@@ -179,15 +176,11 @@ PreparedList PrepareMediaList(
 		}
 		locals.push_back(Platform::File::UrlToLocal(url));
 	}
-	return PrepareMediaList(locals, previewWidth, premium);
+	return CollectMediaList(locals, premium);
 }
 
-PreparedList PrepareMediaList(
-		const QStringList &files,
-		int previewWidth,
-		bool premium) {
+PreparedList CollectMediaList(const QStringList &files, bool premium) {
 	auto result = PreparedList();
-	result.files.reserve(files.size());
 	for (const auto &file : files) {
 		const auto fileinfo = QFileInfo(file);
 		const auto filesize = fileinfo.size();
@@ -210,18 +203,23 @@ PreparedList PrepareMediaList(
 			errorResult.files.back().size = filesize;
 			return errorResult;
 		}
-		if (result.files.size() < Ui::MaxAlbumItems()) {
-			result.files.emplace_back(file);
-			result.files.back().size = filesize;
-		} else {
-			result.filesToProcess.emplace_back(file);
-			result.files.back().size = filesize;
-		}
+		result.filesToProcess.emplace_back(file);
+		result.filesToProcess.back().size = filesize;
 	}
-	PrepareDetailsInParallel(result, previewWidth);
 	return result;
 }
 
+// Callers that check the first file before showing anything prepare it
+// right away, SendFilesBox prepares the rest in background.
+void PrepareFirstFile(PreparedList &list, int previewWidth) {
+	if (!list.files.empty() || list.filesToProcess.empty()) {
+		return;
+	}
+	list.files.push_back(std::move(list.filesToProcess.front()));
+	list.filesToProcess.pop_front();
+	PrepareDetails(list.files.front(), previewWidth, PhotoSideLimit());
+}
+
 PreparedList PrepareMediaFromImage(
 		QImage &&image,
 		QByteArray &&content,
@@ -239,8 +237,8 @@ PreparedList PrepareMediaFromImage(
 			animated,
 			file.information);
 	}
-	result.files.push_back(std::move(file));
-	PrepareDetailsInParallel(result, previewWidth);
+	result.filesToProcess.push_back(std::move(file));
+	PrepareFirstFile(result, previewWidth);
 	return result;
 }
 
@@ -47,6 +47,16 @@ enum class MimeDataState {
 	const QStringList &files,
 	int previewWidth,
 	bool premium);
+
+// Only checks the paths and sizes, all files are left in filesToProcess,
+// for SendFilesBox to prepare them in background.
+[[nodiscard]] Ui::PreparedList CollectMediaList(
+	const QList<QUrl> &files,
+	bool premium);
+[[nodiscard]] Ui::PreparedList CollectMediaList(
+	const QStringList &files,
+	bool premium);
+void PrepareFirstFile(Ui::PreparedList &list, int previewWidth);
 [[nodiscard]] Ui::PreparedList PrepareMediaFromImage(
 	QImage &&image,
 	QByteArray &&content,
@@ -8,6 +8,11 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "storage/storage_sparse_ids_list.h"
 
 namespace Storage {
+namespace {
+
+constexpr auto kInsertOneByOneLimit = 8;
+
+} // namespace
 
 SparseIdsList::Slice::Slice(
 	base::flat_set<MsgId> &&messages,
@@ -23,7 +28,19 @@ void SparseIdsList::Slice::merge(
 	Expects(moreNoSkipRange.from <= range.till);
 	Expects(range.from <= moreNoSkipRange.till);
 
-	messages.merge(std::begin(moreMessages), std::end(moreMessages));
+	const auto from = std::begin(moreMessages);
+	const auto till = std::end(moreMessages);
+	if (std::distance(from, till) <= kInsertOneByOneLimit
+		|| (std::is_sorted(from, till)
+			&& (messages.empty() || messages.back() < *from))) {
+		// Appending ascending ids or adding just a few of them is much
+		// cheaper than sorting the whole merged vector again.
+		for (const auto &message : moreMessages) {
+			messages.insert(message);
+		}
+	} else {
+		messages.merge(from, till);
+	}
 	range = {
 		qMin(range.from, moreNoSkipRange.from),
 		qMax(range.till, moreNoSkipRange.till)
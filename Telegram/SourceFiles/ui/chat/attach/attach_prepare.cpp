@@ -121,11 +121,14 @@ bool PreparedList::canBeSentInSlowmode() const {
 }
 
 bool PreparedList::canBeSentInSlowmodeWith(const PreparedList &other) const {
-	if (!filesToProcess.empty() || !other.filesToProcess.empty()) {
-		return false;
-	} else if (files.size() + other.files.size() < 2) {
+	// Files still in preparation are checked once they are prepared.
+	const auto count = files.size()
+		+ filesToProcess.size()
+		+ other.files.size()
+		+ other.filesToProcess.size();
+	if (count < 2) {
 		return true;
-	} else if (files.size() + other.files.size() > kMaxAlbumCount) {
+	} else if (count > kMaxAlbumCount) {
 		return false;
 	}
 
@@ -58,6 +58,11 @@ constexpr auto kMinimalForwardDelay = crl::time(500);
 constexpr auto kMinimalAlertDelay = crl::time(500);
 constexpr auto kWaitingForAllGroupedDelay = crl::time(1000);
 constexpr auto kReactionNotificationEach = 60 * 60 * crl::time(1000);
+constexpr auto kWaitersQueueSlack = 16;
+
+constexpr auto kWaiterLater = [](const auto &a, const auto &b) {
+	return a.when > b.when;
+};
 
 #ifdef Q_OS_MAC
 constexpr auto kSystemAlertDuration = crl::time(1000);
@@ -131,6 +136,15 @@ base::options::toggle OptionGNotification({
 	.restartRequired = true,
 });
 
+const char kOptionNotificationsDigest[] = "notifications-digest";
+
+base::options::toggle OptionNotificationsDigest({
+	.id = kOptionNotificationsDigest,
+	.name = "Notifications digest",
+	.description = "Show a single notification with a message count"
+		" for several messages that arrived in one chat at once.",
+});
+
 struct System::Waiter {
 	NotificationInHistoryKey key;
 	UserData *reactionSender = nullptr;
@@ -367,12 +381,15 @@ void System::schedule(Data::ItemNotification notification) {
 		auto &addTo = ready ? _waiters : _settingWaiters;
 		const auto it = addTo.find(thread);
 		if (it == addTo.end() || it->second.when > timing.when) {
-			addTo.emplace(thread, Waiter{
+			const auto added = addTo.emplace(thread, Waiter{
 				.key = key,
 				.reactionSender = notification.reactionSender,
 				.type = notification.type,
 				.when = timing.when,
-			});
+			}).second;
+			if (ready && added) {
+				queueWaiter(thread, timing.when);
+			}
 		}
 	}
 	if (ready) {
@@ -394,6 +411,7 @@ void System::clearAll() {
 	_whenMaps.clear();
 	_whenAlerts.clear();
 	_waiters.clear();
+	_waitersQueue.clear();
 	_settingWaiters.clear();
 	_watchedTopics.clear();
 }
@@ -501,6 +519,7 @@ void System::clearAllFast() {
 	_whenMaps.clear();
 	_whenAlerts.clear();
 	_waiters.clear();
+	_waitersQueue.clear();
 	_settingWaiters.clear();
 	_watchedTopics.clear();
 }
@@ -526,7 +545,9 @@ void System::checkDelayed() {
 				|| !item->notificationReady()) {
 				return false;
 			}
-			_waiters.emplace(i->first, i->second);
+			if (_waiters.emplace(i->first, i->second).second) {
+				queueWaiter(i->first, i->second.when);
+			}
 			return true;
 		}();
 		if (remove) {
@@ -556,6 +577,71 @@ void System::showGrouped() {
 	}
 }
 
+void System::queueWaiter(not_null<Data::Thread*> thread, crl::time when) {
+	if (_waitersQueue.size() >= 2 * _waiters.size() + kWaitersQueueSlack) {
+		// Drop entries left from removed or rescheduled waiters.
+		_waitersQueue.clear();
+		for (const auto &[waiting, waiter] : _waiters) {
+			_waitersQueue.push_back({ waiter.when, waiting });
+		}
+		ranges::make_heap(_waitersQueue, kWaiterLater);
+		return;
+	}
+	_waitersQueue.push_back({ when, thread });
+	ranges::push_heap(_waitersQueue, kWaiterLater);
+}
+
+void System::popWaiter() {
+	Expects(!_waitersQueue.empty());
+
+	ranges::pop_heap(_waitersQueue, kWaiterLater);
+	_waitersQueue.pop_back();
+}
+
+Data::Thread *System::nextWaiter() {
+	while (!_waitersQueue.empty()) {
+		const auto queued = _waitersQueue.front();
+		const auto i = _waiters.find(queued.thread);
+		if (i == _waiters.end() || i->second.when != queued.when) {
+			popWaiter();
+			continue;
+		}
+		const auto thread = i->first;
+		auto current = thread->currentNotification();
+		if (current && current->item->id != i->second.key.messageId) {
+			auto j = _whenMaps.find(thread);
+			if (j == _whenMaps.end()) {
+				thread->clearNotifications();
+				_waiters.erase(i);
+				popWaiter();
+				continue;
+			}
+			do {
+				auto k = j->second.find(*current);
+				if (k != j->second.cend()) {
+					i->second.key = k->first;
+					i->second.when = k->second;
+					break;
+				}
+				thread->skipNotification();
+				current = thread->currentNotification();
+			} while (current);
+		}
+		if (!current) {
+			_whenMaps.remove(thread);
+			_waiters.erase(i);
+			popWaiter();
+			continue;
+		} else if (i->second.when != queued.when) {
+			popWaiter();
+			queueWaiter(thread, i->second.when);
+			continue;
+		}
+		return thread;
+	}
+	return nullptr;
+}
+
 void System::showNext() {
 	Expects(_manager != nullptr);
 
@@ -645,46 +731,13 @@ void System::showNext() {
 	}
 
 	while (true) {
-		auto next = 0LL;
-		auto notify = std::optional<Data::ItemNotification>();
-		auto notifyThread = (Data::Thread*)nullptr;
-		for (auto i = _waiters.begin(); i != _waiters.end();) {
-			const auto thread = i->first;
-			auto current = thread->currentNotification();
-			if (current && current->item->id != i->second.key.messageId) {
-				auto j = _whenMaps.find(thread);
-				if (j == _whenMaps.end()) {
-					thread->clearNotifications();
-					i = _waiters.erase(i);
-					continue;
-				}
-				do {
-					auto k = j->second.find(*current);
-					if (k != j->second.cend()) {
-						i->second.key = k->first;
-						i->second.when = k->second;
-						break;
-					}
-					thread->skipNotification();
-					current = thread->currentNotification();
-				} while (current);
-			}
-			if (!current) {
-				_whenMaps.remove(thread);
-				i = _waiters.erase(i);
-				continue;
-			}
-			auto when = i->second.when;
-			if (!notify || next > when) {
-				next = when;
-				notify = current,
-				notifyThread = thread;
-			}
-			++i;
-		}
-		if (!notify) {
+		const auto notifyThread = nextWaiter();
+		if (!notifyThread) {
 			break;
-		} else if (next > ms) {
+		}
+		auto next = _waiters.find(notifyThread)->second.when;
+		const auto notify = notifyThread->currentNotification();
+		if (next > ms) {
 			if (nextAlert && nextAlert < next) {
 				next = nextAlert;
 				nextAlert = 0;
@@ -692,6 +745,8 @@ void System::showNext() {
 			_waitTimer.callOnce(next - ms);
 			break;
 		}
+		popWaiter();
+
 		const auto notifyItem = notify->item;
 		const auto messageType = (notify->type
 			== Data::ItemNotificationType::Message);
@@ -798,10 +853,34 @@ void System::showNext() {
 			const auto reaction = reactionNotification
 				? notify->item->lookupUnreadReaction(notify->reactionSender)
 				: Data::ReactionId();
+
+			// Merge all the messages from this thread that are already due.
+			auto digestItem = notify->item;
+			auto digestCount = 0;
+			if (!reactionNotification
+				&& OptionNotificationsDigest.value()
+				&& j != _whenMaps.cend()) {
+				digestCount = 1;
+				while (const auto next = thread->currentNotification()) {
+					const auto k = j->second.find(*next);
+					if (k == j->second.cend()) {
+						thread->skipNotification();
+						continue;
+					} else if (k->second > ms
+						|| next->type != Data::ItemNotificationType::Message) {
+						break;
+					}
+					digestItem = next->item;
+					++digestCount;
+					j->second.erase(k);
+					thread->skipNotification();
+				}
+			}
 			if (!reactionNotification || !reaction.empty()) {
 				_manager->showNotification({
-					.item = notify->item,
+					.item = digestItem,
 					.forwardedCount = forwardedCount,
+					.digestCount = digestCount,
 					.reactionFrom = notify->reactionSender,
 					.reactionId = reaction,
 				});
@@ -811,6 +890,8 @@ void System::showNext() {
 		if (!thread->hasNotification()) {
 			_waiters.remove(thread);
 			_whenMaps.remove(thread);
+		} else if (const auto i = _waiters.find(thread); i != _waiters.end()) {
+			queueWaiter(thread, i->second.when);
 		}
 	}
 	if (nextAlert) {
@@ -1221,6 +1302,9 @@ void NativeManager::doShowNotification(NotificationFields &&fields) {
 				.spoilerLoginCode = options.spoilerLoginCode,
 			})),
 			(fields.forwardedCount == 1));
+	const auto digest = (fields.digestCount > 1 && !reactionFrom)
+		? tr::lng_notification_digest(tr::now, lt_count, fields.digestCount)
+		: QString();
 
 	// #TODO optimize
 	auto userpicView = item->history()->peer->createUserpicView();
@@ -1231,7 +1315,11 @@ void NativeManager::doShowNotification(NotificationFields &&fields) {
 		item->id,
 		scheduled ? WrapFromScheduled(fullTitle) : fullTitle,
 		subtitle,
-		text,
+		(digest.isEmpty()
+			? text
+			: options.hideMessageText
+			? digest
+			: (digest + '\n' + text)),
 		options);
 }
 
@@ -87,6 +87,8 @@ namespace Window::Notifications {
 
 extern const char kOptionGNotification[];
 extern base::options::toggle OptionGNotification;
+extern const char kOptionNotificationsDigest[];
+extern base::options::toggle OptionNotificationsDigest;
 
 class Manager;
 
@@ -151,6 +153,10 @@ private:
 		crl::time delay = 0;
 		crl::time when = 0;
 	};
+	struct QueuedWaiter {
+		crl::time when = 0;
+		not_null<Data::Thread*> thread;
+	};
 	struct ReactionNotificationId {
 		FullMsgId itemId;
 		uint64 sessionId = 0;
@@ -177,6 +183,9 @@ private:
 
 	void showNext();
 	void showGrouped();
+	void queueWaiter(not_null<Data::Thread*> thread, crl::time when);
+	void popWaiter();
+	[[nodiscard]] Data::Thread *nextWaiter();
 	void ensureSoundCreated();
 	[[nodiscard]] not_null<Media::Audio::Track*> lookupSound(
 		not_null<Data::Session*> owner,
@@ -190,6 +199,9 @@ private:
 
 	base::flat_map<not_null<Data::Thread*>, Waiter> _waiters;
 	base::flat_map<not_null<Data::Thread*>, Waiter> _settingWaiters;
+
+	// Min-heap by 'when' over _waiters, may contain outdated entries.
+	std::vector<QueuedWaiter> _waitersQueue;
 	base::Timer _waitTimer;
 	base::Timer _waitForAllGroupedTimer;
 
@@ -274,6 +286,7 @@ public:
 	struct NotificationFields {
 		not_null<HistoryItem*> item;
 		int forwardedCount = 0;
+		int digestCount = 0;
 		PeerData *reactionFrom = nullptr;
 		Data::ReactionId reactionId;
 	};
@@ -109,6 +109,7 @@ Manager::QueuedNotification::QueuedNotification(NotificationFields &&fields)
 	: QString())
 , item((fields.forwardedCount < 2) ? fields.item.get() : nullptr)
 , forwardedCount(fields.forwardedCount)
+, digestCount(fields.digestCount)
 , fromScheduled(reaction.empty() && (fields.item->out() || peer->isSelf())
 	&& fields.item->isFromScheduled()) {
 }
@@ -261,6 +262,7 @@ void Manager::showNextFromQueue() {
 			queued.item,
 			queued.reaction,
 			queued.forwardedCount,
+			queued.digestCount,
 			queued.fromScheduled,
 			startPosition,
 			startShift,
@@ -645,6 +647,7 @@ Notification::Notification(
 	HistoryItem *item,
 	const Data::ReactionId &reaction,
 	int forwardedCount,
+	int digestCount,
 	bool fromScheduled,
 	QPoint startPosition,
 	int shift,
@@ -660,6 +663,7 @@ Notification::Notification(
 , _reaction(reaction)
 , _item(item)
 , _forwardedCount(forwardedCount)
+, _digestCount(digestCount)
 , _fromScheduled(fromScheduled)
 , _close(this, st::notifyClose)
 , _reply(this, tr::lng_notification_reply(), st::defaultBoxButton) {
@@ -948,11 +952,17 @@ void Notification::updateNotifyDisplay() {
 					_reaction,
 					options.hideMessageText))
 				: _item
-				? _item->toPreview({
+				? (_digestCount > 1
+					? Ui::Text::Colorized(tr::lng_notification_digest(
+						tr::now,
+						lt_count,
+						_digestCount)).append('\n')
+					: TextWithEntities()
+				).append(_item->toPreview({
 					.hideSender = reminder,
 					.generateImages = false,
 					.spoilerLoginCode = options.spoilerLoginCode,
-				}).text
+				}).text)
 				: ((!_author.isEmpty()
 						? Ui::Text::Colorized(_author)
 						: TextWithEntities()
@@ -965,7 +975,9 @@ void Notification::updateNotifyDisplay() {
 			const auto options = TextParseOptions{
 				(TextParseColorized
 					| TextParseMarkdown
-					| (_forwardedCount > 1 ? TextParseMultiline : 0)),
+					| ((_forwardedCount > 1 || _digestCount > 1)
+					? TextParseMultiline
+					: 0)),
 				0,
 				0,
 				Qt::LayoutDirectionAuto,
@@ -92,6 +92,10 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include <QAction>
 #include <QtGui/QGuiApplication>
 
+// AyuGram includes
+#include "ayu/ayu_settings.h"
+#include "ayu/ui/sections/edited/edited_log_section.h"
+
 namespace Window {
 namespace {
 
@@ -269,6 +273,7 @@ private:
 	void addViewDiscussion();
 	void addToggleTopicClosed();
 	void addExportChat();
+	void addEditsHistory();
 	void addTranslate();
 	void addReport();
 	void addNewContact();
@@ -808,6 +813,19 @@ void Filler::addExportChat() {
 		&st::menuIconExport);
 }
 
+void Filler::addEditsHistory() {
+	if (_thread->asTopic()
+		|| !AyuSettings::getInstance().saveMessagesHistory) {
+		return;
+	}
+	const auto controller = _controller;
+	const auto peer = _peer;
+	_addAction(tr::ayu_EditsHistoryTitle(tr::now), [=] {
+		controller->showSection(
+			std::make_shared<EditedLog::SectionMemento>(peer, nullptr));
+	}, &st::menuIconEdit);
+}
+
 void Filler::addTranslate() {
 	if (_peer->translationFlag() != PeerData::TranslationFlag::Disabled
 		|| !_peer->session().premium()
@@ -1241,6 +1259,7 @@ void Filler::fillHistoryActions() {
 	addThemeEdit();
 	addViewDiscussion();
 	addExportChat();
+	addEditsHistory();
 	addTranslate();
 	addReport();
 	addClearHistory();
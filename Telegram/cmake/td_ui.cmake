@@ -125,6 +125,8 @@ PRIVATE
     media/clip/media_clip_check_streaming.h
     media/clip/media_clip_ffmpeg.cpp
     media/clip/media_clip_ffmpeg.h
+    media/clip/media_clip_frames_cache.cpp
+    media/clip/media_clip_frames_cache.h
     media/clip/media_clip_implementation.cpp
     media/clip/media_clip_implementation.h
     media/clip/media_clip_reader.cpp